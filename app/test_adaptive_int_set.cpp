@@ -0,0 +1,132 @@
+#include"ra/adaptive_int_set.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<iostream>
+#include<iterator>
+#include<random>
+#include<set>
+#include<vector>
+
+namespace rc = ra::container;
+
+// Returns true if s holds exactly the elements of ref (in order).
+template <class Key>
+bool same_elements(const rc::adaptive_int_set<Key>& s, const std::set<Key>& ref) {
+	if(s.size() != ref.size()){
+		return false;
+	}
+	auto j = ref.begin();
+	for(auto i=s.begin(); i!=s.end(); ++i, ++j){
+		if(*i != *j){
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(){
+	using std::cout;
+	using std::endl;
+	using set = rc::adaptive_int_set<int>;
+	// Test a sparse set
+	set obj_A;
+	obj_A.insert(1000);
+	obj_A.insert(7);
+	obj_A.insert(300);
+	RA_CHECK(!obj_A.insert(7).second);
+	RA_CHECK(!obj_A.is_dense() && obj_A.size() == 3);
+	for(int x : obj_A){
+		cout<<x<<" ";
+	}
+	cout<<endl;
+	// Test switching to a bitmap as the set becomes dense
+	for(int i=0; i<1000; i+=3){
+		obj_A.insert(i);
+	}
+	RA_CHECK(obj_A.is_dense());
+	RA_CHECK(obj_A.contains(999) && obj_A.contains(1000) && !obj_A.contains(1));
+	RA_CHECK(*obj_A.find(300) == 300 && obj_A.find(301) == obj_A.end());
+	RA_CHECK(*obj_A.insert(2).first == 2);
+	cout<<(obj_A.size())<<" "<<(obj_A.is_dense())<<endl;
+	// Test that lookups and inserts within the bitmap do not allocate
+	ra::harness::alloc_scope allocs;
+	obj_A.insert(500);
+	RA_CHECK(obj_A.contains(500));
+	RA_CHECK(allocs.allocations() == 0);
+	// Test erase and switching back to a sorted array
+	set::const_iterator i = obj_A.find(2);
+	i = obj_A.erase(i);
+	RA_CHECK(*i == 3);
+	while(obj_A.size() > 3){
+		obj_A.erase(obj_A.begin());
+	}
+	RA_CHECK(!obj_A.is_dense());
+	for(int x : obj_A){
+		cout<<x<<" ";
+	}
+	cout<<endl;
+	// Test negative elements (which are never kept in a bitmap)
+	set obj_B;
+	for(int x=0; x<64; ++x){
+		obj_B.insert(x);
+	}
+	RA_CHECK(obj_B.is_dense());
+	obj_B.insert(-5);
+	RA_CHECK(!obj_B.is_dense() && *obj_B.begin() == -5 && obj_B.size() == 65);
+	// Test move and swap
+	set obj_C(std::move(obj_B));
+	RA_CHECK(obj_B.size() == 0 && obj_C.size() == 65);
+	obj_C.swap(obj_A);
+	RA_CHECK(obj_A.size() == 65 && obj_C.size() == 3);
+	// Test the rest of the sv_set interface
+	RA_CHECK(obj_A.key_comp()(-5, 0));
+	const int sorted[] = {-1, 4, 9};
+	set obj_E(set::ordered_and_unique_range(), sorted, 3);
+	obj_E.reserve(10);
+	RA_CHECK(!obj_E.is_dense() && obj_E.capacity() >= 10 && obj_E.size() == 3);
+	allocs.reset();
+	for(int x=10; x<17; ++x){
+		obj_E.insert(x);
+	}
+	RA_CHECK(allocs.allocations() == 0);
+	obj_E.shrink_to_fit();
+	RA_CHECK(obj_E.capacity() == 10);
+	RA_CHECK(*obj_E.lower_bound(5) == 9 && *obj_E.lower_bound(-3) == -1 && obj_E.lower_bound(17) == obj_E.end());
+	RA_CHECK(*std::prev(obj_E.end()) == 16 && *--obj_E.find(9) == 4);
+	set obj_F;
+	for(int x=0; x<200; x+=2){
+		obj_F.insert(x);
+	}
+	RA_CHECK(obj_F.is_dense() && obj_F.capacity() >= 200);
+	RA_CHECK(*obj_F.lower_bound(63) == 64 && *obj_F.lower_bound(-3) == 0 && obj_F.lower_bound(199) == obj_F.end());
+	RA_CHECK(*std::prev(obj_F.end()) == 198 && *std::prev(obj_F.lower_bound(128)) == 126 && *--obj_F.find(2) == 0);
+	bool reversed = true;
+	int expected = 198;
+	for(auto r = obj_F.end(); r != obj_F.begin(); expected -= 2){
+		reversed = reversed && *--r == expected;
+	}
+	RA_CHECK(reversed && expected == -2);
+	// Test random operations against std::set
+	rc::adaptive_int_set<unsigned> obj_D;
+	std::set<unsigned> ref;
+	std::mt19937 gen(1);
+	bool ok = true;
+	for(int round=0; round<20000; ++round){
+		unsigned x = gen() % (round < 10000 ? 2000 : 200000);
+		if(gen() % 3){
+			ok = ok && (obj_D.insert(x).second == ref.insert(x).second);
+		}
+		else{
+			auto f = obj_D.find(x);
+			ok = ok && ((f != obj_D.end()) == (ref.erase(x) == 1));
+			if(f != obj_D.end()){
+				obj_D.erase(f);
+			}
+		}
+	}
+	RA_CHECK(ok);
+	RA_CHECK(same_elements(obj_D, ref));
+	obj_D.clear();
+	RA_CHECK(obj_D.size() == 0 && obj_D.begin() == obj_D.end());
+	return ra::harness::exit_status();
+}
@@ -0,0 +1,64 @@
+#include"ra/frozen_sv_set.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<iostream>
+#include<functional>
+#include<string_view>
+
+namespace rc = ra::container;
+
+// A keyword table sorted at compile time.
+constexpr rc::frozen_sv_set<std::string_view, 6> keywords({"while", "if", "else", "for", "if", "return"});
+static_assert(keywords.size() == 5);
+static_assert(keywords.contains("for"));
+static_assert(!keywords.contains("do"));
+static_assert(*keywords.begin() == "else");
+static_assert(*(keywords.end()-1) == "while");
+
+// An opcode table with a descending order.
+constexpr rc::frozen_sv_set<int, 5, std::greater<int>> opcodes({0x10, 0x90, 0x20, 0x01, 0x20});
+static_assert(opcodes.size() == 4);
+static_assert(*opcodes.begin() == 0x90);
+static_assert(opcodes.find(0x20) == opcodes.begin()+1);
+static_assert(opcodes.find(0x02) == opcodes.end());
+
+// Deduction of the key type and capacity.
+constexpr int primes_buf[] = {7, 2, 5, 3, 11, 13};
+constexpr rc::frozen_sv_set primes(primes_buf);
+static_assert(primes.capacity() == 6 && primes.size() == 6);
+
+int main(){
+	using std::cout;
+	using std::endl;
+	// Test iteration
+	for(std::string_view k : keywords){
+		cout<<k<<" ";
+	}
+	cout<<endl;
+	// Test runtime lookups (which must not allocate)
+	ra::harness::alloc_scope allocs;
+	for(int i=0; i<20; ++i){
+		bool expected = (i==2 || i==3 || i==5 || i==7 || i==11 || i==13);
+		RA_CHECK(primes.contains(i) == expected);
+	}
+	// Test lower_bound and find beyond the largest element
+	RA_CHECK(primes.lower_bound(4) == primes.begin()+2);
+	RA_CHECK(primes.lower_bound(14) == primes.end());
+	RA_CHECK(keywords.find("zzz") == keywords.end());
+	// Test the non-unrolled search used for large capacities
+	int big_buf[1000];
+	for(int i=0; i<1000; ++i){
+		big_buf[i] = (i * 7919) % 1000;
+	}
+	rc::frozen_sv_set<int, 1000> big(big_buf);
+	RA_CHECK(big.size() == 1000);
+	bool all_found = true;
+	for(int i=0; i<1000; ++i){
+		all_found = all_found && (big.find(i) == big.begin()+i);
+	}
+	RA_CHECK(all_found);
+	RA_CHECK(!big.contains(-1) && !big.contains(1000));
+	RA_CHECK(allocs.allocations() == 0);
+	cout<<(primes.size())<<" "<<(big.size())<<endl;
+	return ra::harness::exit_status();
+}
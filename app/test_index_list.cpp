@@ -0,0 +1,150 @@
+#include"ra/index_list.hpp"
+#include"ra/intrusive_list.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<algorithm>
+#include<cstring>
+#include<iostream>
+#include<iterator>
+#include<list>
+#include<random>
+#include<ranges>
+#include<type_traits>
+#include<vector>
+
+namespace ri = ra::intrusive;
+
+// An object on up to four lists at once
+struct Item {
+	int value;
+	ri::index_hook h0;
+	ri::index_hook h1;
+	ri::index_hook h2;
+	ri::index_hook h3;
+};
+
+using list0 = ri::index_list<Item, &Item::h0>;
+using list1 = ri::index_list<Item, &Item::h1>;
+
+static_assert(sizeof(ri::index_hook) == 8 && sizeof(ri::index_hook) * 2 == sizeof(ri::list_hook));
+static_assert(sizeof(Item) == sizeof(int) + 4 * 8);
+static_assert(std::is_trivially_copyable_v<Item> && std::is_trivially_copyable_v<ri::index_list_head>);
+static_assert(std::bidirectional_iterator<list0::iterator>);
+static_assert(std::bidirectional_iterator<list0::const_iterator>);
+static_assert(std::is_convertible_v<list0::iterator, list0::const_iterator> &&
+  !std::is_convertible_v<list0::const_iterator, list0::iterator>);
+// A const list gives only non-mutating access to its elements
+static_assert(std::is_same_v<decltype(*std::declval<const list0&>().begin()), const Item&>);
+static_assert(std::is_same_v<decltype(std::declval<const list0&>().front()), const Item&>);
+
+// Elements that are their own hooks
+struct Slot : ri::index_hook {
+	int value = 0;
+};
+
+std::vector<int> values(const list0& l){
+	std::vector<int> v;
+	for(const Item& x : l){
+		v.push_back(x.value);
+	}
+	return v;
+}
+
+int main(){
+	using std::cout;
+	using std::endl;
+	const int n = 10;
+	std::vector<Item> arena(n);
+	for(int i=0; i<n; ++i){
+		arena[i].value = i;
+	}
+	ri::index_list_head head0;
+	ri::index_list_head head1;
+	ri::index_list_head head2;
+	list0 obj_A(arena.data(), head0);
+	list1 obj_B(arena.data(), head1);
+	RA_CHECK(obj_A.empty() && obj_A.begin() == obj_A.end());
+	ra::harness::alloc_scope allocs;
+	// Test insertion on two lists through different hooks
+	for(Item& x : arena){
+		obj_A.push_back(x);
+		obj_B.push_front(x);
+	}
+	RA_CHECK(obj_A.size() == 10 && obj_B.size() == 10 && obj_A.front().value == 0 && obj_B.front().value == 9);
+	RA_CHECK(obj_A.index_of(arena[4]) == 4 && obj_A.iterator_to(arena[4]).index() == 4);
+	RA_CHECK(arena[3].h0.is_linked() && !arena[3].h2.is_linked());
+	// Test traversal of a const list
+	const list1& obj_B_ref = obj_B;
+	list1::const_iterator ci = obj_B_ref.end();
+	--ci;
+	RA_CHECK(&*ci == &obj_B_ref.back() && ci->value == 0 && ci.index() == 0);
+	RA_CHECK(list1::const_iterator(obj_B.begin()) == obj_B_ref.iterator_to(arena[9]));
+	// Test erase, insert and reverse traversal
+	obj_A.erase(arena[0]);
+	obj_A.erase(arena[9]);
+	list0::iterator i5 = obj_A.erase(obj_A.iterator_to(arena[4]));
+	RA_CHECK(i5->value == 5 && !arena[4].h0.is_linked() && arena[4].h1.is_linked());
+	obj_A.insert(i5, arena[9]);
+	obj_A.pop_front();
+	obj_A.pop_back();
+	RA_CHECK(allocs.allocations() == 0);
+	RA_CHECK((values(obj_A) == std::vector<int>{2, 3, 9, 5, 6, 7}) && obj_A.back().value == 7);
+	int expected = 0;
+	for(const Item& x : obj_B | std::views::reverse){
+		RA_CHECK(x.value == expected++);
+	}
+	// Test splice
+	list0 obj_C(arena.data(), head2);
+	obj_C.push_back(arena[0]);
+	obj_C.push_back(arena[1]);
+	RA_CHECK_ALLOCS(0, obj_A.splice(obj_A.iterator_to(arena[9]), obj_C));
+	RA_CHECK(obj_C.empty() && obj_A.size() == 8 && (values(obj_A) == std::vector<int>{2, 3, 0, 1, 9, 5, 6, 7}));
+	obj_C.splice(obj_C.end(), obj_A);
+	RA_CHECK(obj_A.empty() && obj_C.size() == 8 && obj_C.back().value == 7);
+	// The lists are position-independent: a bitwise copy of the arena
+	// and the heads (e.g., at another address in another process) holds
+	// the same lists
+	std::vector<Item> copy(n);
+	std::memcpy(copy.data(), arena.data(), n * sizeof(Item));
+	ri::index_list_head head2_copy = head2;
+	list0 obj_D(copy.data(), head2_copy);
+	RA_CHECK((values(obj_D) == std::vector<int>{2, 3, 0, 1, 9, 5, 6, 7}) && &obj_D.front() == &copy[2]);
+	obj_D.clear();
+	RA_CHECK(obj_D.empty() && !copy[2].h0.is_linked() && arena[2].h0.is_linked() && obj_C.size() == 8);
+	std::vector<int> disposed;
+	obj_C.clear_and_dispose([&disposed](Item* x) { disposed.push_back(x->value); });
+	RA_CHECK((disposed == std::vector<int>{2, 3, 0, 1, 9, 5, 6, 7}) && obj_C.empty() && !arena[7].h0.is_linked());
+	obj_B.clear();
+	// Test random operations on base hooks against std::list
+	std::vector<Slot> slots(500);
+	for(int i=0; i<500; ++i){
+		slots[i].value = i;
+	}
+	ri::index_list_head slot_head;
+	ri::index_list<Slot, ri::base_hook> obj_E(slots.data(), slot_head);
+	std::list<int> model;
+	std::mt19937 rng(5);
+	bool consistent = true;
+	for(int step=0; step<20000; ++step){
+		Slot& s = slots[rng() % 500];
+		if(s.is_linked()){
+			obj_E.erase(s);
+			model.remove(s.value);
+		}
+		else if(rng() % 2){
+			obj_E.push_front(s);
+			model.push_front(s.value);
+		}
+		else{
+			obj_E.push_back(s);
+			model.push_back(s.value);
+		}
+		if(step % 500 == 0){
+			consistent = consistent && obj_E.size() == model.size() &&
+			  std::ranges::equal(obj_E, model, {}, &Slot::value);
+		}
+	}
+	RA_CHECK(consistent && std::ranges::equal(obj_E | std::views::reverse, model | std::views::reverse, {}, &Slot::value));
+	cout<<model.size()<<endl;
+	return ra::harness::exit_status();
+}
@@ -1,4 +1,9 @@
 #include "ra/intrusive_list.hpp"
+#include "alloc_tracker.hpp"
+#include "check.hpp"
+#include<algorithm>
+#include<iterator>
+#include<ranges>
 #include<vector>
 #include<iostream>
 #include<utility>
@@ -20,6 +25,48 @@ using itr = ri::list<Widget, &Widget::hook>::list_iterator;
 using itr2 = ri::list<Widget, &Widget::hook2>::list_iterator;
 //using itr2 = std::reverse_iterator<itr2_mine, std::bidirectional_iterator_tag>;
 
+struct Timer {
+	Timer(int value_) : value(value_) {}
+	int value;
+	ri::auto_unlink_hook hook;
+	ri::auto_unlink_hook hook2;
+};
+
+using rit = ri::list<Timer, &Timer::hook>;
+using rit2 = ri::list<Timer, &Timer::hook2>;
+
+// Iterators are a single pointer, and lists are bidirectional ranges
+static_assert(sizeof(riw::iterator) == sizeof(void*) && sizeof(riw::const_iterator) == sizeof(void*));
+static_assert(std::is_trivially_copyable_v<riw::iterator> && std::is_trivially_copyable_v<riw::const_iterator>);
+static_assert(std::bidirectional_iterator<riw::iterator> && std::bidirectional_iterator<riw::const_iterator>);
+static_assert(std::ranges::bidirectional_range<riw> && std::ranges::common_range<const riw>);
+static_assert(std::bidirectional_iterator<rit::iterator> && std::ranges::bidirectional_range<rit>);
+
+// Lists that do not keep their sizes are just a sentinel hook
+using riw_nosize = ri::list<Widget, &Widget::hook, ra::util::no_stats, false>;
+static_assert(riw::constant_time_size && !riw_nosize::constant_time_size && !rit::constant_time_size);
+static_assert(sizeof(riw_nosize) == sizeof(ri::list_hook) && sizeof(rit) == sizeof(ri::list_hook));
+static_assert(sizeof(riw) == sizeof(ri::list_hook) + sizeof(std::size_t));
+
+// Elements that are their own hooks (base hooks)
+struct Node : ri::list_hook {
+	Node(int value_) : value(value_) {}
+	int value;
+};
+
+struct Session : ri::auto_unlink_hook {
+	Session(int value_) : value(value_) {}
+	int value;
+};
+
+// A class that is not standard layout, with a member hook
+struct Shape {
+	Shape(int value_) : value(value_) {}
+	virtual ~Shape() = default;
+	int value;
+	ri::list_hook hook;
+};
+
 
 void print_list(riw& obj){
 	for(itr i=(obj.begin()); i!=(obj.end()); ++i){
@@ -55,6 +102,8 @@ int main() {
 	for(int i=9; i>=0; --i){
 		storage.push_back(Widget(i));
 	}
+	// No list operation may allocate.
+	ra::harness::alloc_scope list_allocs;
 	// Test default constructor
 	riw obj_A;
 	riw2 obj_AA;
@@ -105,6 +154,298 @@ int main() {
 	obj_AA.swap(obj_BB);
 	print_list2(obj_AA);
 	print_list2(obj_BB);
+	// Test operation statistics
+	using criw = ri::list<Widget, &Widget::hook, ra::util::count_stats>;
+	static_assert(sizeof(riw) == sizeof(criw) - sizeof(ra::util::list_stats));
+	criw obj_E;
+	Widget st1(3);
+	Widget st2(4);
+	obj_E.push_back(st1);
+	obj_E.push_back(st2);
+	for(criw::iterator i=(obj_E.begin()); i!=(obj_E.end()); ++i){}
+	obj_E.pop_back();
+	ra::util::list_stats lst = obj_E.stats();
+	cout<<(lst.inserts)<<" "<<(lst.erases)<<" "<<(lst.iterations)<<" "<<(lst.high_water_size)<<endl;
+	RA_CHECK(lst.iterations == 1);
+	obj_E.clear();
+	cout<<(obj_E.stats().erases)<<endl;
+	// push_front and pop_front do not count as traversals
+	obj_E.push_front(st1);
+	obj_E.push_front(st2);
+	obj_E.pop_front();
+	RA_CHECK(obj_E.stats().iterations == 1 && obj_E.stats().inserts == 4);
+	obj_E.clear();
+	// Test push_front, front and pop_front
+	std::vector<Widget> storage2;
+	for(int i=0; i<8; ++i){
+		storage2.push_back(Widget(i));
+	}
+	list_allocs.reset();
+	riw obj_F;
+	for(int i=3; i>=0; --i){
+		obj_F.push_front(storage2[i]);
+	}
+	RA_CHECK(obj_F.front().value == 0 && obj_F.back().value == 3);
+	obj_F.pop_front();
+	RA_CHECK(obj_F.front().value == 1 && obj_F.size() == 3);
+	print_list(obj_F);
+	// Test splice of a whole list, a single element and a range
+	riw obj_G;
+	for(int i=4; i<8; ++i){
+		obj_G.push_back(storage2[i]);
+	}
+	obj_F.splice(obj_F.end(), obj_G);
+	RA_CHECK(obj_F.size() == 7 && obj_G.size() == 0);
+	print_list(obj_F);
+	obj_G.splice(obj_G.end(), obj_F, itr(&storage2[5]));
+	obj_G.splice(obj_G.begin(), obj_F, obj_F.begin(), itr(&storage2[4]), 3);
+	RA_CHECK(obj_F.size() == 3 && obj_G.size() == 4);
+	print_list(obj_F);
+	print_list(obj_G);
+	obj_G.splice(obj_G.begin(), obj_G, itr(&storage2[5]));
+	obj_G.splice(obj_G.end(), obj_F, obj_F.begin(), obj_F.end());
+	RA_CHECK(obj_F.size() == 0 && obj_G.size() == 7);
+	print_list(obj_G);
+	// Test range erase
+	itr after = obj_G.erase(++obj_G.begin(), itr(&storage2[7]));
+	RA_CHECK(after->value == 7 && obj_G.size() == 2);
+	print_list(obj_G);
+	obj_G.erase(obj_G.begin(), obj_G.end());
+	RA_CHECK(obj_G.size() == 0 && obj_G.begin() == obj_G.end());
+	// Test move from an empty list
+	riw obj_H(std::move(obj_G));
+	RA_CHECK(obj_H.size() == 0 && obj_H.begin() == obj_H.end());
+	RA_CHECK(list_allocs.allocations() == 0);
+	// Test sort (which must be stable and must not allocate)
+	std::vector<Widget> storage3;
+	for(int i=0; i<1000; ++i){
+		storage3.push_back(Widget((i * 7919) % 100));
+	}
+	auto by_value = [](const Widget& a, const Widget& b) { return a.value < b.value; };
+	riw obj_I;
+	for(Widget& w : storage3){
+		obj_I.push_back(w);
+	}
+	RA_CHECK_ALLOCS(0, obj_I.sort(by_value));
+	bool sorted = true;
+	const Widget* prev = nullptr;
+	for(const Widget& w : obj_I){
+		sorted = sorted && (!prev || prev->value < w.value || (prev->value == w.value && prev < &w));
+		prev = &w;
+	}
+	RA_CHECK(sorted && obj_I.size() == 1000 && obj_I.back().value == 99);
+	// Test unique
+	RA_CHECK(obj_I.unique([](const Widget& a, const Widget& b) { return a.value == b.value; }) == 900);
+	RA_CHECK(obj_I.size() == 100 && obj_I.front().value == 0 && obj_I.back().value == 99);
+	// Test remove_if
+	RA_CHECK(obj_I.remove_if([](const Widget& w) { return w.value % 2; }) == 50);
+	RA_CHECK(obj_I.size() == 50);
+	// Test merge
+	riw obj_J;
+	for(int i=0; i<5; ++i){
+		obj_J.push_back(storage2[i]);
+	}
+	obj_J.reverse();
+	RA_CHECK(obj_J.front().value == 4 && obj_J.back().value == 0);
+	obj_J.reverse();
+	RA_CHECK_ALLOCS(0, obj_I.merge(obj_J, by_value));
+	RA_CHECK(obj_I.size() == 55 && obj_J.size() == 0);
+	int sum = 0;
+	int n_le_4 = 0;
+	for(itr i=obj_I.begin(); i!=obj_I.end() && i->value <= 4; ++i){
+		sum += i->value;
+		++n_le_4;
+	}
+	RA_CHECK(n_le_4 == 8 && sum == 16);
+	obj_I.clear();
+	RA_CHECK(obj_A.size() == 2 && obj_A.back().value == 19);
+	// Test is_linked and iterator_to
+	Widget w(21);
+	RA_CHECK(!w.hook.is_linked());
+	obj_A.push_front(w);
+	RA_CHECK(w.hook.is_linked() && !w.hook2.is_linked());
+	obj_A.pop_front();
+	RA_CHECK(!w.hook.is_linked());
+	// Copies of an element (linked or not) are not in any list, and
+	// assigning to a linked element leaves it in its list
+	Widget w_copy(w);
+	std::vector<Widget> w_copies(3, w);
+	RA_CHECK(!w_copy.hook.is_linked() && !w_copies[0].hook.is_linked() && !w_copies[2].hook2.is_linked());
+	obj_A.push_back(w);
+	Widget w_copy2(w);
+	RA_CHECK(w.hook.is_linked() && !w_copy2.hook.is_linked() && w_copy2.value == 21);
+	w = Widget(22);
+	RA_CHECK(w.hook.is_linked() && w.value == 22 && &obj_A.back() == &w);
+	w_copy = w;
+	RA_CHECK(!w_copy.hook.is_linked() && w_copy.value == 22);
+	obj_A.pop_back();
+	RA_CHECK(!w.hook.is_linked());
+	RA_CHECK(riw::s_iterator_to(obj_A.back()) == --obj_A.end());
+	RA_CHECK(obj_A.iterator_to(obj_A.front()) == obj_A.begin());
+	obj_A.erase(obj_A.iterator_to(obj_A.front()));
+	RA_CHECK(obj_A.size() == 1 && obj_A.front().value == 19);
+	// Test auto-unlink hooks: elements leave every list they are on when
+	// they are destroyed or unlinked
+	static_assert(!rit::constant_time_size && riw::constant_time_size);
+	rit obj_K;
+	rit2 obj_L;
+	{
+		std::vector<Timer> timers;
+		for(int i=0; i<6; ++i){
+			timers.push_back(Timer(i));
+		}
+		std::vector<Timer> copies(timers);
+		RA_CHECK_ALLOCS(0, for(Timer& t : timers) { obj_K.push_back(t); obj_L.push_front(t); });
+		RA_CHECK(obj_K.size() == 6 && obj_L.size() == 6 && obj_L.front().value == 5);
+		RA_CHECK(!copies[0].hook.is_linked() && timers[0].hook.is_linked());
+		RA_CHECK_ALLOCS(0, timers[2].hook.unlink());
+		RA_CHECK(obj_K.size() == 5 && !timers[2].hook.is_linked() && timers[2].hook2.is_linked());
+		timers[3].hook2.unlink();
+		RA_CHECK(obj_L.size() == 5);
+		rit::iterator i = rit::s_iterator_to(timers[4]);
+		RA_CHECK(obj_K.erase(i)->value == 5 && obj_K.size() == 4);
+		int sum = 0;
+		for(const Timer& t : obj_K){
+			sum += t.value;
+		}
+		RA_CHECK(sum == 0 + 1 + 3 + 5);
+		obj_L.clear();
+		RA_CHECK(obj_L.empty() && !timers[0].hook2.is_linked());
+		// Destroying the timers removes them from obj_K
+	}
+	RA_CHECK(obj_K.empty() && obj_K.size() == 0);
+	{
+		Timer t(7);
+		obj_K.push_back(t);
+		RA_CHECK(obj_K.size() == 1);
+	}
+	RA_CHECK(obj_K.empty() && obj_K.begin() == obj_K.end());
+	// Test disposers
+	std::vector<Widget> storage4;
+	for(int i=0; i<10; ++i){
+		storage4.push_back(Widget(i));
+	}
+	riw obj_M;
+	for(Widget& x : storage4){
+		obj_M.push_back(x);
+	}
+	std::vector<int> disposed;
+	disposed.reserve(10);
+	auto collect = [&disposed](Widget* x) { disposed.push_back(x->value); };
+	RA_CHECK_ALLOCS(0, obj_M.pop_front_and_dispose(collect));
+	obj_M.pop_back_and_dispose(collect);
+	RA_CHECK(obj_M.size() == 8 && !storage4[0].hook.is_linked() && !storage4[9].hook.is_linked());
+	RA_CHECK(obj_M.erase_and_dispose(obj_M.begin(), collect)->value == 2);
+	RA_CHECK(obj_M.remove_and_dispose_if([](const Widget& x) { return x.value % 2; }, collect) == 3);
+	itr i6 = obj_M.erase_and_dispose(obj_M.begin(), obj_M.iterator_to(storage4[6]), collect);
+	RA_CHECK(i6 == obj_M.begin() && i6->value == 6 && obj_M.size() == 2);
+	obj_M.clear_and_dispose(collect);
+	RA_CHECK(obj_M.empty() && obj_M.size() == 0 && !storage4[8].hook.is_linked());
+	RA_CHECK((disposed == std::vector<int>{0, 9, 1, 3, 5, 7, 2, 4, 6, 8}));
+	// The disposer may destroy elements (even those with auto-unlink hooks)
+	rit obj_N;
+	for(int i=0; i<5; ++i){
+		obj_N.push_back(*new Timer(i));
+	}
+	int deleted = 0;
+	obj_N.clear_and_dispose([&deleted](Timer* t) { delete t; ++deleted; });
+	RA_CHECK(deleted == 5 && obj_N.empty());
+	// Test reverse iteration, standard algorithms and range adaptors
+	std::vector<Widget> storage5;
+	for(int i=0; i<6; ++i){
+		storage5.push_back(Widget(i));
+	}
+	riw obj_O;
+	for(Widget& x : storage5){
+		obj_O.push_back(x);
+	}
+	const riw& cobj_O = obj_O;
+	std::vector<int> seen;
+	for(auto i = cobj_O.rbegin(); i != cobj_O.rend(); ++i){
+		seen.push_back(i->value);
+	}
+	RA_CHECK((seen == std::vector<int>{5, 4, 3, 2, 1, 0}));
+	seen.clear();
+	for(const Widget& x : obj_O | std::views::reverse | std::views::filter([](const Widget& x) { return x.value % 2 == 0; })){
+		seen.push_back(x.value);
+	}
+	RA_CHECK((seen == std::vector<int>{4, 2, 0}));
+	RA_CHECK(std::ranges::find(obj_O, 3, &Widget::value)->value == 3);
+	RA_CHECK(std::ranges::distance(obj_O) == 6 && std::ranges::count_if(cobj_O, [](const Widget& x) { return x.value > 3; }) == 2);
+	riw::const_iterator ci = obj_O.begin();
+	RA_CHECK(ci == obj_O.begin() && obj_O.begin() == ci && std::prev(obj_O.end())->value == 5);
+	std::ranges::for_each(obj_O, [](Widget& x) { x.value *= 10; });
+	RA_CHECK(std::ranges::max_element(obj_O, {}, &Widget::value)->value == 50);
+	obj_O.clear();
+	// Test lists that do not keep their sizes
+	std::vector<Widget> storage6;
+	for(int i=0; i<8; ++i){
+		storage6.push_back(Widget(i));
+	}
+	riw_nosize obj_S;
+	riw_nosize obj_T;
+	RA_CHECK(obj_S.empty() && obj_S.size() == 0);
+	for(Widget& x : storage6){
+		obj_S.push_back(x);
+	}
+	RA_CHECK(!obj_S.empty() && obj_S.size() == 8);
+	obj_T.splice(obj_T.end(), obj_S, riw_nosize::iterator(&storage6[2]), riw_nosize::iterator(&storage6[6]));
+	RA_CHECK(obj_S.size() == 4 && obj_T.size() == 4 && obj_T.front().value == 2 && obj_T.back().value == 5);
+	obj_T.splice(obj_T.begin(), obj_S);
+	RA_CHECK(obj_S.empty() && obj_T.size() == 8 && obj_T.back().value == 5);
+	obj_T.pop_front();
+	obj_T.erase(obj_T.iterator_to(storage6[3]));
+	RA_CHECK(obj_T.size() == 6 && !storage6[3].hook.is_linked());
+	riw_nosize obj_U(std::move(obj_T));
+	RA_CHECK(obj_T.empty() && obj_U.size() == 6);
+	obj_U.clear();
+	RA_CHECK(obj_U.empty() && obj_U.size() == 0);
+	ri::list<Widget, &Widget::hook, ra::util::count_stats, false> obj_V;
+	obj_V.push_back(storage6[0]);
+	obj_V.push_back(storage6[1]);
+	obj_V.clear();
+	RA_CHECK(obj_V.stats().inserts == 2 && obj_V.stats().erases == 2);
+	// Test base hooks
+	static_assert(std::is_same_v<ri::list<Node, ri::base_hook>::hook_type, ri::list_hook>);
+	static_assert(std::is_same_v<ri::list<Session, ri::base_hook>::hook_type, ri::auto_unlink_hook>);
+	static_assert(!ri::list<Session, ri::base_hook>::constant_time_size);
+	std::vector<Node> nodes;
+	for(int i=0; i<5; ++i){
+		nodes.push_back(Node(i));
+	}
+	ri::list<Node, ri::base_hook> obj_P;
+	for(Node& x : nodes){
+		obj_P.push_front(x);
+	}
+	RA_CHECK(obj_P.size() == 5 && &obj_P.front() == &nodes[4] && &obj_P.back() == &nodes[0]);
+	RA_CHECK(obj_P.iterator_to(nodes[2])->value == 2 && nodes[2].is_linked());
+	obj_P.sort([](const Node& x, const Node& y) { return x.value < y.value; });
+	RA_CHECK(obj_P.begin()->value == 0 && (--obj_P.end())->value == 4);
+	obj_P.erase(obj_P.iterator_to(nodes[1]));
+	RA_CHECK(obj_P.size() == 4 && !nodes[1].is_linked());
+	obj_P.clear();
+	ri::list<Session, ri::base_hook> obj_Q;
+	{
+		Session s1(1);
+		Session s2(2);
+		obj_Q.push_back(s1);
+		obj_Q.push_back(s2);
+		RA_CHECK(obj_Q.size() == 2 && obj_Q.back().value == 2);
+	}
+	RA_CHECK(obj_Q.empty());
+	// Test a member hook in a class that is not standard layout (the
+	// hook is not at offset zero)
+	std::vector<Shape> shapes;
+	for(int i=0; i<3; ++i){
+		shapes.push_back(Shape(i));
+	}
+	ri::list<Shape, &Shape::hook> obj_R;
+	for(Shape& x : shapes){
+		obj_R.push_back(x);
+	}
+	RA_CHECK(&obj_R.front() == &shapes[0] && &obj_R.back() == &shapes[2]);
+	RA_CHECK(&*obj_R.iterator_to(shapes[1]) == &shapes[1] && (++obj_R.begin())->value == 1);
+	obj_R.clear();
 
 
 	/*riw obj_D;
@@ -134,4 +475,5 @@ int main() {
 	}
 	values.clear();
 	*/
+	return ra::harness::exit_status();
 }
@@ -0,0 +1,160 @@
+#include"ra/intrusive_set.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<algorithm>
+#include<iostream>
+#include<iterator>
+#include<memory>
+#include<random>
+#include<ranges>
+#include<set>
+#include<vector>
+
+namespace ri = ra::intrusive;
+
+struct Order {
+	Order(int id_ = 0, int price_ = 0) : id(id_), price(price_) {}
+	int id;
+	int price;
+	ri::set_hook by_price;
+	ri::set_hook by_id;
+};
+
+// Orders by price, and accepts prices as keys.
+struct price_less {
+	using is_transparent = void;
+	bool operator()(const Order& x, const Order& y) const { return x.price < y.price; }
+	bool operator()(const Order& x, int price) const { return x.price < price; }
+	bool operator()(int price, const Order& y) const { return price < y.price; }
+};
+struct id_less {
+	bool operator()(const Order& x, const Order& y) const { return x.id < y.id; }
+};
+
+using price_index = ri::multiset<Order, &Order::by_price, price_less>;
+using id_index = ri::set<Order, &Order::by_id, id_less>;
+
+static_assert(sizeof(price_index::iterator) == sizeof(void*) && std::is_trivially_copyable_v<price_index::iterator>);
+static_assert(std::bidirectional_iterator<price_index::iterator> && std::bidirectional_iterator<price_index::const_iterator>);
+static_assert(std::ranges::bidirectional_range<id_index> && std::ranges::common_range<const id_index>);
+
+// Elements that are their own hooks
+struct Level : ri::set_hook {
+	Level(int value_) : value(value_) {}
+	int value;
+	bool operator<(const Level& other) const { return value < other.value; }
+};
+
+int main(){
+	using std::cout;
+	using std::endl;
+	// Test insert, lookup and erase on two indexes at once
+	std::vector<Order> storage;
+	for(int i=0; i<20; ++i){
+		storage.push_back(Order(i, 100 + (i * 7) % 10));
+	}
+	price_index obj_A;
+	id_index obj_B;
+	std::vector<int> disposed;
+	disposed.reserve(20);
+	ra::harness::alloc_scope allocs;
+	RA_CHECK(obj_A.empty() && obj_A.begin() == obj_A.end() && obj_A.verify());
+	for(Order& o : storage){
+		obj_A.insert(o);
+		RA_CHECK(obj_B.insert(o).second);
+	}
+	RA_CHECK(obj_A.size() == 20 && obj_B.size() == 20 && obj_A.verify() && obj_B.verify());
+	Order dup(5, 0);
+	std::pair<id_index::iterator, bool> res = obj_B.insert(dup);
+	RA_CHECK(!res.second && &*res.first == &storage[5] && !dup.by_id.is_linked());
+	RA_CHECK(obj_A.begin()->price == 100 && obj_A.rbegin()->price == 109 && obj_B.rbegin()->id == 19);
+	// Equivalent orders are kept in insertion order
+	RA_CHECK(obj_A.count(103) == 2 && obj_A.find(103)->id == 9 && std::next(obj_A.find(103))->id == 19);
+	RA_CHECK(obj_A.lower_bound(104)->price == 104 && obj_A.upper_bound(109) == obj_A.end() && !obj_A.contains(99));
+	RA_CHECK(obj_B.find(Order(7)) == obj_B.iterator_to(storage[7]) && obj_B.find(Order(20)) == obj_B.end());
+	// Erase by reference, iterator and key
+	obj_A.erase(storage[9]);
+	obj_B.erase(storage[9]);
+	RA_CHECK(!storage[9].by_price.is_linked() && obj_A.find(103)->id == 19 && obj_A.verify() && obj_B.verify());
+	price_index::iterator after = obj_A.erase(obj_A.iterator_to(storage[0]));
+	RA_CHECK(after->price == 100 && after->id == 10 && obj_A.size() == 18);
+	RA_CHECK(obj_A.erase_key(105) == 2 && obj_A.size() == 16 && obj_A.verify());
+	auto collect = [&disposed](Order* o) { disposed.push_back(o->id); };
+	obj_A.erase_and_dispose(obj_A.begin(), collect);
+	RA_CHECK(disposed.size() == 1 && disposed[0] == 10 && obj_A.begin()->price == 101);
+	std::pair<price_index::iterator, price_index::iterator> range = obj_A.equal_range(108);
+	obj_A.erase(range.first, range.second);
+	RA_CHECK(obj_A.size() == 13 && !obj_A.contains(108) && obj_A.verify());
+	// Iterate both ways
+	int prev = 0;
+	bool sorted = true;
+	for(const Order& o : obj_A){
+		sorted = sorted && o.price >= prev;
+		prev = o.price;
+	}
+	for(const Order& o : obj_B | std::views::reverse){
+		sorted = sorted && o.id < prev;
+		prev = o.id;
+	}
+	RA_CHECK(sorted && std::ranges::distance(obj_B) == 19);
+	obj_A.clear_and_dispose(collect);
+	RA_CHECK(obj_A.empty() && disposed.size() == 14 && !storage[1].by_price.is_linked() && storage[1].by_id.is_linked());
+	// Moving a set moves its elements
+	id_index obj_C(std::move(obj_B));
+	RA_CHECK(obj_B.empty() && obj_B.verify() && obj_C.size() == 19 && obj_C.verify() && obj_C.begin()->id == 0);
+	obj_C.clear();
+	RA_CHECK(obj_C.empty() && !storage[4].by_id.is_linked());
+	RA_CHECK(allocs.allocations() == 0);
+	// Test base hooks; destroying the set unlinks its elements
+	std::vector<Level> levels;
+	for(int i=0; i<10; ++i){
+		levels.push_back(Level(i * 3 % 10));
+	}
+	{
+		ri::set<Level, ri::base_hook> obj_D;
+		for(Level& l : levels){
+			obj_D.insert(l);
+		}
+		RA_CHECK(obj_D.size() == 10 && obj_D.begin()->value == 0 && obj_D.verify());
+		RA_CHECK(obj_D.lower_bound(Level(4))->value == 4 && levels[3].is_linked());
+	}
+	RA_CHECK(!levels[3].is_linked());
+	// Test random operations against std::multiset
+	const int n = 3000;
+	std::vector<std::unique_ptr<Order>> orders;
+	for(int i=0; i<n; ++i){
+		orders.push_back(std::make_unique<Order>(i, 0));
+	}
+	std::mt19937 rng(11);
+	price_index obj_E;
+	std::multiset<int> model;
+	bool consistent = true;
+	for(int step=0; step<40000; ++step){
+		Order& o = *orders[rng() % n];
+		if(o.by_price.is_linked()){
+			model.erase(model.find(o.price));
+			if(rng() % 2){
+				obj_E.erase(o);
+			}
+			else{
+				obj_E.erase(obj_E.iterator_to(o));
+			}
+		}
+		else{
+			o.price = int(rng() % 500);
+			obj_E.insert(o);
+			model.insert(o.price);
+		}
+		if(step % 1000 == 0){
+			consistent = consistent && obj_E.verify() && obj_E.size() == model.size() &&
+			  std::ranges::equal(obj_E, model, {}, &Order::price);
+			int k = int(rng() % 500);
+			consistent = consistent && obj_E.count(k) == model.count(k) &&
+			  (obj_E.lower_bound(k) == obj_E.end()) == (model.lower_bound(k) == model.end());
+		}
+	}
+	RA_CHECK(consistent && obj_E.verify());
+	obj_E.clear();
+	cout<<model.size()<<endl;
+	return ra::harness::exit_status();
+}
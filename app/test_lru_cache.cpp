@@ -0,0 +1,128 @@
+#include"ra/lru_cache.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<atomic>
+#include<iostream>
+#include<string>
+#include<thread>
+#include<vector>
+
+namespace ri = ra::intrusive;
+
+struct Entry {
+	Entry(int key_ = 0, std::string value_ = std::string()) : key(key_), value(value_) {}
+	int key;
+	std::string value;
+	ri::list_hook lru_hook;
+	ri::list_hook hash_hook;
+};
+
+using cache = ri::lru_cache<Entry, &Entry::key, &Entry::lru_hook, &Entry::hash_hook>;
+
+// Puts all keys into the same bucket.
+struct bad_hash {
+	std::size_t operator()(int) const { return 0; }
+};
+
+int main(){
+	using std::cout;
+	using std::endl;
+	std::vector<Entry> storage;
+	for(int i=0; i<10; ++i){
+		storage.push_back(Entry(i, "value " + std::to_string(i)));
+	}
+	std::vector<int> evicted;
+	evicted.reserve(10);
+	auto dispose = [&evicted](Entry* e) { evicted.push_back(e->key); };
+	// Test insert, get and eviction
+	cache obj_A(3);
+	RA_CHECK(obj_A.empty() && obj_A.capacity() == 3 && obj_A.bucket_count() == 4);
+	RA_CHECK(cache(0).bucket_count() == 2 && cache(8, 100).bucket_count() == 128);
+	ra::harness::alloc_scope allocs;
+	for(int i=0; i<3; ++i){
+		RA_CHECK(obj_A.insert(storage[i], dispose).second);
+	}
+	RA_CHECK(obj_A.size() == 3 && evicted.empty());
+	RA_CHECK(obj_A.get(0) == &storage[0] && obj_A.get(7) == nullptr);
+	RA_CHECK(obj_A.entries().front().key == 0 && obj_A.entries().back().key == 1);
+	RA_CHECK(obj_A.peek(2) == &storage[2] && obj_A.entries().front().key == 0);
+	obj_A.insert(storage[3], dispose);
+	RA_CHECK(obj_A.size() == 3 && evicted.size() == 1 && evicted[0] == 1 && obj_A.get(1) == nullptr);
+	RA_CHECK(!storage[1].lru_hook.is_linked() && !storage[1].hash_hook.is_linked());
+	// A duplicate key is not inserted
+	Entry dup(3, "other");
+	std::pair<Entry*, bool> res = obj_A.insert(dup, dispose);
+	RA_CHECK(!res.second && res.first == &storage[3] && !dup.lru_hook.is_linked());
+	// Test erase
+	RA_CHECK(obj_A.erase(0, dispose) && !obj_A.erase(0, dispose) && evicted.back() == 0);
+	obj_A.erase(storage[2]);
+	RA_CHECK(obj_A.size() == 1 && obj_A.get(2) == nullptr && obj_A.get(3)->value == "value 3");
+	obj_A.clear_and_dispose(dispose);
+	RA_CHECK(obj_A.empty() && evicted.back() == 3);
+	RA_CHECK(allocs.allocations() == 0);
+	// Test a cache whose keys all collide
+	ri::lru_cache<Entry, &Entry::key, &Entry::lru_hook, &Entry::hash_hook, bad_hash> obj_B(8);
+	for(Entry& e : storage){
+		obj_B.insert(e, [](Entry*) {});
+	}
+	RA_CHECK(obj_B.size() == 8 && obj_B.get(1) == nullptr && obj_B.get(9) == &storage[9] && obj_B.get(2) == &storage[2]);
+	obj_B.clear_and_dispose([](Entry*) {});
+	// Test that destroying a cache resets the hooks of its entries
+	{
+		cache obj_D(4);
+		for(int i=0; i<3; ++i){
+			obj_D.insert(storage[i], dispose);
+		}
+		RA_CHECK(storage[0].lru_hook.is_linked() && storage[0].hash_hook.is_linked());
+	}
+	RA_CHECK(!storage[0].lru_hook.is_linked() && !storage[2].hash_hook.is_linked());
+	// Test a cache with capacity zero: an inserted entry is evicted at
+	// once, and insert does not return a pointer to it
+	cache obj_E(0);
+	evicted.clear();
+	res = obj_E.insert(storage[4], dispose);
+	RA_CHECK(res.first == nullptr && !res.second && evicted.size() == 1 && evicted[0] == 4);
+	RA_CHECK(obj_E.empty() && obj_E.get(4) == nullptr && !storage[4].lru_hook.is_linked() && !storage[4].hash_hook.is_linked());
+	// Test a sharded cache used by several threads; each thread owns its
+	// entries, and evicted entries are returned to their owners
+	const int threads = 4;
+	const int per_thread = 200;
+	ri::sharded_lru_cache<Entry, &Entry::key, &Entry::lru_hook, &Entry::hash_hook, 8> obj_C(1000);
+	std::atomic<int> hits(0);
+	std::atomic<bool> consistent(true);
+	std::vector<std::vector<Entry>> entries(threads);
+	for(int t=0; t<threads; ++t){
+		for(int i=0; i<per_thread; ++i){
+			entries[t].push_back(Entry(t * per_thread + i, std::to_string(t * per_thread + i)));
+		}
+	}
+	std::vector<std::thread> workers;
+	for(int t=0; t<threads; ++t){
+		workers.emplace_back([&, t]{
+			for(int round=0; round<5; ++round){
+				for(Entry& e : entries[t]){
+					// The disposer runs with the shard locked; the entry is
+					// simply no longer in the cache.
+					bool found = obj_C.get(e.key, [&](Entry& x) {
+						consistent = consistent && &x == &e && x.value == std::to_string(x.key);
+					});
+					if(found){
+						++hits;
+					}
+					else{
+						obj_C.insert(e, [](Entry*) {});
+					}
+				}
+			}
+		});
+	}
+	for(std::thread& t : workers){
+		t.join();
+	}
+	RA_CHECK(consistent.load() && hits.load() > 0);
+	RA_CHECK(obj_C.size() <= 1000 && obj_C.size() > 0);
+	obj_C.clear_and_dispose([](Entry*) {});
+	RA_CHECK(obj_C.size() == 0);
+	cout<<hits.load()<<endl;
+	return ra::harness::exit_status();
+}
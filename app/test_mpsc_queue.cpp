@@ -0,0 +1,90 @@
+#include"ra/mpsc_queue.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<iostream>
+#include<thread>
+#include<vector>
+
+namespace ri = ra::intrusive;
+
+struct Message {
+	Message(int producer_ = 0, int seq_ = 0) : producer(producer_), seq(seq_) {}
+	int producer;
+	int seq;
+	ri::mpsc_hook queue_hook;
+	ri::list_hook hook;
+};
+
+using queue = ri::mpsc_queue<Message, &Message::queue_hook>;
+using mlist = ri::list<Message, &Message::hook>;
+
+int main(){
+	using std::cout;
+	using std::endl;
+	// Test single-threaded push, pop and pop_all
+	std::vector<Message> storage;
+	for(int i=0; i<5; ++i){
+		storage.push_back(Message(0, i));
+	}
+	queue obj_A;
+	RA_CHECK(obj_A.empty() && obj_A.pop() == nullptr);
+	ra::harness::alloc_scope allocs;
+	for(Message& m : storage){
+		obj_A.push(m);
+	}
+	Message* m = obj_A.pop();
+	RA_CHECK(m == &storage[0] && !obj_A.empty());
+	mlist obj_B = obj_A.pop_all<&Message::hook>();
+	RA_CHECK(obj_B.size() == 4 && obj_B.front().seq == 1 && obj_B.back().seq == 4);
+	RA_CHECK(obj_A.empty() && obj_A.pop() == nullptr);
+	obj_B.clear();
+	// Test reusing nodes after the queue has been drained
+	obj_A.push(storage[2]);
+	obj_A.push(storage[3]);
+	RA_CHECK(obj_A.pop() == &storage[2] && obj_A.pop() == &storage[3] && obj_A.pop() == nullptr);
+	RA_CHECK(allocs.allocations() == 0);
+	// Test concurrent producers
+	const int producers = 4;
+	const int per_producer = 100000;
+	std::vector<std::vector<Message>> messages(producers);
+	for(int p=0; p<producers; ++p){
+		for(int i=0; i<per_producer; ++i){
+			messages[p].push_back(Message(p, i));
+		}
+	}
+	queue obj_C;
+	std::vector<std::thread> threads;
+	for(int p=0; p<producers; ++p){
+		threads.emplace_back([&obj_C, &messages, p]{
+			for(Message& x : messages[p]){
+				obj_C.push(x);
+			}
+		});
+	}
+	std::vector<int> next_seq(producers, 0);
+	bool in_order = true;
+	int received = 0;
+	mlist batch;
+	while(received < producers * per_producer){
+		if(received % 3 == 0){
+			if(Message* x = obj_C.pop()){
+				in_order = in_order && (x->seq == next_seq[x->producer]++);
+				++received;
+			}
+		}
+		else{
+			received += int(obj_C.pop_all(batch));
+			for(const Message& x : batch){
+				in_order = in_order && (x.seq == next_seq[x.producer]++);
+			}
+			batch.clear();
+		}
+	}
+	for(std::thread& t : threads){
+		t.join();
+	}
+	RA_CHECK(in_order);
+	RA_CHECK(obj_C.pop() == nullptr);
+	cout<<received<<endl;
+	return ra::harness::exit_status();
+}
@@ -0,0 +1,147 @@
+#include"ra/object_pool.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<atomic>
+#include<iostream>
+#include<set>
+#include<thread>
+#include<vector>
+
+namespace ri = ra::intrusive;
+
+struct Connection {
+	int id = 0;
+	int owner = -1;
+	ri::list_hook hook;
+};
+
+struct Timeout {
+	int id = 0;
+	ri::auto_unlink_hook hook;
+};
+
+using cpool = ri::object_pool<Connection, &Connection::hook>;
+using clist = ri::list<Connection, &Connection::hook>;
+
+int main(){
+	using std::cout;
+	using std::endl;
+	// Test acquire and release
+	cpool obj_A(16);
+	RA_CHECK(obj_A.capacity() == 0 && obj_A.available() == 0);
+	Connection& c1 = obj_A.acquire();
+	RA_CHECK(obj_A.capacity() == 16 && obj_A.available() == 15 && !c1.hook.is_linked());
+	c1.id = 1;
+	obj_A.release(c1);
+	RA_CHECK(obj_A.available() == 16);
+	Connection& c2 = obj_A.acquire();
+	RA_CHECK(&c2 == &c1 && c2.id == 1);
+	obj_A.release(c2);
+	// Test moving objects between a list of objects in use and the pool
+	// without allocating
+	obj_A.reserve(100);
+	RA_CHECK(obj_A.capacity() == 112 && obj_A.available() == 112);
+	clist in_use;
+	ra::harness::alloc_scope allocs;
+	for(int i=0; i<100; ++i){
+		Connection& c = obj_A.acquire();
+		c.id = i;
+		in_use.push_back(c);
+	}
+	RA_CHECK(obj_A.available() == 12 && in_use.size() == 100);
+	in_use.remove_and_dispose_if([](const Connection& c) { return c.id % 2; },
+	  [&obj_A](Connection* c) { obj_A.release(*c); });
+	RA_CHECK(obj_A.available() == 62 && in_use.size() == 50);
+	in_use.clear_and_dispose([&obj_A](Connection* c) { obj_A.release(*c); });
+	RA_CHECK(obj_A.available() == 112 && in_use.empty());
+	RA_CHECK(allocs.allocations() == 0);
+	// Test batches
+	clist batch;
+	obj_A.acquire(batch, 30);
+	RA_CHECK(batch.size() == 30 && obj_A.available() == 82);
+	obj_A.release(batch, 30);
+	RA_CHECK(batch.empty() && obj_A.available() == 112);
+	obj_A.acquire(batch, 200);
+	RA_CHECK(batch.size() == 200 && obj_A.capacity() == 208 && obj_A.available() == 8);
+	obj_A.release(batch, 200);
+	// Test taking whole batches: a pool with chunks of 32 objects keeps
+	// them in batches of 8
+	cpool obj_E(32, 8);
+	RA_CHECK(obj_E.batch_size() == 8);
+	RA_CHECK(obj_E.acquire(batch) == 8 && batch.size() == 8 && obj_E.available() == 24);
+	RA_CHECK_ALLOCS(0, obj_E.release(batch, 8));
+	RA_CHECK(batch.empty() && obj_E.available() == 32);
+	// Test a cache, which takes a batch at a time from the pool, and
+	// gives back a batch when it holds twice the batch size
+	{
+		cpool::cache obj_B(obj_E);
+		std::vector<Connection*> held;
+		held.reserve(20);
+		ra::harness::alloc_scope cache_allocs;
+		for(int i=0; i<20; ++i){
+			held.push_back(&obj_B.acquire());
+		}
+		RA_CHECK(obj_B.size() == 4 && obj_E.available() == 32 - 24);
+		for(Connection* c : held){
+			obj_B.release(*c);
+		}
+		// The cache keeps at most 2 * 8 - 1 objects
+		RA_CHECK(obj_B.size() == 8 && obj_E.available() == 32 - 8);
+		RA_CHECK(cache_allocs.allocations() == 0);
+	}
+	RA_CHECK(obj_E.available() == 32 && obj_E.capacity() == 32);
+	// Test a pool of objects with auto-unlink hooks
+	{
+		ri::object_pool<Timeout, &Timeout::hook, ri::null_mutex> obj_C(4);
+		ri::list<Timeout, &Timeout::hook> timers;
+		for(int i=0; i<10; ++i){
+			timers.push_back(obj_C.acquire());
+		}
+		RA_CHECK(obj_C.capacity() == 12 && obj_C.available() == 2);
+		timers.clear_and_dispose([&obj_C](Timeout* t) { obj_C.release(*t); });
+		RA_CHECK(obj_C.available() == 12);
+	}
+	// Test threads with caches sharing a pool: no object is ever held by
+	// two threads at once
+	const int threads = 4;
+	const int rounds = 20000;
+	cpool obj_D(64);
+	std::atomic<bool> exclusive(true);
+	std::vector<std::thread> workers;
+	for(int t=0; t<threads; ++t){
+		workers.emplace_back([&obj_D, &exclusive, t]{
+			cpool::cache local(obj_D, 16);
+			std::vector<Connection*> held;
+			for(int r=0; r<rounds; ++r){
+				if(held.size() < 40 && (r % 3 != 0 || held.empty())){
+					Connection& c = local.acquire();
+					if(c.owner != -1){
+						exclusive = false;
+					}
+					c.owner = t;
+					held.push_back(&c);
+				}
+				else{
+					Connection* c = held.back();
+					held.pop_back();
+					if(c->owner != t){
+						exclusive = false;
+					}
+					c->owner = -1;
+					local.release(*c);
+				}
+			}
+			for(Connection* c : held){
+				c->owner = -1;
+				local.release(*c);
+			}
+		});
+	}
+	for(std::thread& t : workers){
+		t.join();
+	}
+	RA_CHECK(exclusive.load());
+	RA_CHECK(obj_D.available() == obj_D.capacity());
+	cout<<obj_D.capacity()<<endl;
+	return ra::harness::exit_status();
+}
@@ -1,4 +1,6 @@
 #include"ra/sv_set.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
 #include<iostream>
 #include<utility>
 #include<functional>
@@ -11,22 +13,30 @@ int main(){
 	//using set = typename ra::container::sv_set<int, std::greater<int>>;
 	//using ourange = typename ra::container::sv_set<int, std::greater<int>>::ordered_and_unique_range;
 	// Test Default constructor
+	ra::harness::alloc_scope allocs;
 	set obj_A;
-	// Test Move constructor and move assignment
+	// Test Move constructor and move assignment (neither allocates)
 	set obj_B(std::move(obj_A));
 	set obj_C = std::move(obj_A);
+	RA_CHECK(allocs.allocations() == 0);
 	// Test Copy constructor and copy assignment
 	set obj_D(obj_B);
 	set obj_E = obj_D;
 	// Test key compare function
 	//cout<< (obj_E.key_comp()) << endl;
 	// Test reserve
-	obj_E.reserve(10);
-	// Test insert
-	obj_E.insert(7);
-	obj_E.insert(2);
-	obj_E.insert(5);
+	RA_CHECK_ALLOCS(1, obj_E.reserve(10));
+	RA_CHECK_ALLOCS(0, obj_E.reserve(5));
+	// Test insert (no allocation while there is spare capacity)
+	RA_CHECK_ALLOCS(0, obj_E.insert(7));
+	RA_CHECK_ALLOCS(0, obj_E.insert(2));
+	RA_CHECK_ALLOCS(0, obj_E.insert(5));
+	RA_CHECK_ALLOCS(0, obj_E.insert(5));
+	RA_CHECK(obj_E.size() == 3);
+	// Test copying a non-empty set (one allocation)
+	allocs.reset();
 	set obj_EE(obj_E);
+	RA_CHECK(allocs.allocations() == 1 && obj_EE.size() == 3);
 	// Test begin, finish,end,size,and capacity
 	cout<<(*(obj_E.begin()))<<" "<<(*(obj_E.begin()+1))<<" "<<(*(obj_E.begin()+2))<<endl;
 	cout<<(obj_E.size())<<" "<<(obj_E.capacity())<<endl;
@@ -36,8 +46,17 @@ int main(){
 	cout<<(obj_E.size())<<" "<<(obj_E.capacity())<<endl;
 	// Test find
 	cout<<(*(obj_E.find(5)))<<endl;
+	allocs.reset();
+	RA_CHECK(*obj_E.find(5) == 5);
+	RA_CHECK(obj_E.find(4) == obj_E.end());
+	RA_CHECK(allocs.allocations() == 0);
+	// Test insert into a full set (one reallocation)
+	RA_CHECK(obj_EE.size() == obj_EE.capacity());
+	RA_CHECK_ALLOCS(1, obj_EE.insert(1));
+	RA_CHECK(obj_EE.size() == 4 && obj_EE.capacity() > 4);
+	obj_EE.erase(obj_EE.find(1));
 	// Test clear
-	obj_E.clear();
+	RA_CHECK_ALLOCS(0, obj_E.clear());
 	cout<<(obj_E.size())<<" "<<(obj_E.capacity())<<endl;
 	// Test constructor with range of values given
 	int buf_1[] = {6,3,5,4,7,3,1,4,2,6,9};
@@ -52,14 +71,14 @@ int main(){
 	cout<<(*(obj_G.find(7)))<<endl;
 	// Test erase
 	cout<<(obj_F.size())<<endl;
-	obj_F.erase(obj_F.find(3));
+	RA_CHECK_ALLOCS(0, obj_F.erase(obj_F.find(3)));
 	for(int i=0; i<(obj_F.size()); ++i){
 		cout<<(*(obj_F.begin()+i))<<" ";
 	}
 	cout<<endl;
 	cout<<(obj_F.size())<<endl;
 	// Test swap
-	obj_F.swap(obj_EE);
+	RA_CHECK_ALLOCS(0, obj_F.swap(obj_EE));
 	for(int i=0; i<(obj_EE.size()); ++i){
 		cout<<(*(obj_EE.begin()+i))<<" ";
 	}
@@ -68,9 +87,43 @@ int main(){
 		cout<<(*(obj_F.begin()+i))<<" ";
 	}
 	cout<<endl;
-
-
-
-
-
+	// Test operation statistics
+	using cset = typename ra::container::sv_set<int, std::less<int>, ra::util::count_stats>;
+	static_assert(sizeof(set) == sizeof(cset) - sizeof(ra::util::sv_set_stats));
+	cset obj_H;
+	obj_H.reserve(4);
+	for(int i : buf_1){
+		obj_H.insert(i);
+	}
+	obj_H.find(4);
+	obj_H.erase(obj_H.find(1));
+	ra::util::sv_set_stats st = obj_H.stats();
+	// 8 unique elements: reserve(4) and one growth to 8, each inserted
+	// key copied once
+	RA_CHECK(st.comparisons == 86 && st.copies == 8 && st.reallocations == 2);
+	RA_CHECK(st.bytes_allocated == 12 * sizeof(int) && st.high_water_size == 8);
+	// The counters follow the storage they describe
+	cset obj_I(std::move(obj_H));
+	RA_CHECK(obj_I.stats().reallocations == 2 && obj_H.stats().reallocations == 0);
+	obj_H.insert(1);
+	obj_H.swap(obj_I);
+	RA_CHECK(obj_H.stats().high_water_size == 8 && obj_I.stats().high_water_size == 1);
+	obj_I = std::move(obj_H);
+	RA_CHECK(obj_I.stats().comparisons == 86 && obj_H.stats().high_water_size == 0);
+	obj_I.reset_stats();
+	RA_CHECK(obj_I.stats().comparisons == 0 && obj_F.stats().comparisons == 0);
+	// Elements are shifted and relocated by moves; only inserted keys
+	// are copied
+	cset obj_M;
+	obj_M.reserve(4);
+	obj_M.insert(3);
+	obj_M.insert(2);
+	obj_M.insert(1);
+	RA_CHECK(obj_M.stats().moves == 3 && obj_M.stats().copies == 3);
+	obj_M.erase(obj_M.begin());
+	RA_CHECK(obj_M.stats().moves == 5 && obj_M.stats().copies == 3);
+	obj_M.reserve(16);
+	RA_CHECK(obj_M.stats().moves == 7 && obj_M.stats().copies == 3 && obj_M.stats().reallocations == 2);
+	RA_CHECK(obj_M.size() == 2 && *obj_M.begin() == 2 && *(obj_M.begin() + 1) == 3);
+	return ra::harness::exit_status();
 }
@@ -0,0 +1,123 @@
+#include"ra/timer_wheel.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<cstdint>
+#include<iostream>
+#include<memory>
+#include<random>
+#include<vector>
+
+namespace ri = ra::intrusive;
+
+struct Connection {
+	Connection(int id_ = 0) : id(id_) {}
+	int id;
+	ri::timer_hook timeout;
+};
+
+// A small wheel (64^2 = 4096 ticks), so that tests reach the overflow list.
+using wheel = ri::timer_wheel<Connection, &Connection::timeout, 2>;
+
+int main(){
+	using std::cout;
+	using std::endl;
+	// Test scheduling, firing, cancelling and rescheduling
+	std::vector<Connection> storage;
+	for(int i=0; i<6; ++i){
+		storage.push_back(Connection(i));
+	}
+	wheel obj_A(100);
+	RA_CHECK(obj_A.empty() && obj_A.now() == 100);
+	std::vector<int> fired;
+	fired.reserve(16);
+	auto record = [&fired](Connection& c) { fired.push_back(c.id); };
+	ra::harness::alloc_scope allocs;
+	obj_A.schedule(storage[0], 105);
+	obj_A.schedule(storage[1], 300);
+	obj_A.schedule(storage[2], 5000);
+	obj_A.schedule(storage[3], 101);
+	obj_A.schedule(storage[4], 90);
+	obj_A.schedule(storage[5], 1000000);
+	RA_CHECK(!obj_A.empty() && wheel::is_scheduled(storage[2]) && storage[2].timeout.expiry() == 5000);
+	// A past-due timer is due at now()+1, so advancing to now() fires nothing
+	RA_CHECK(storage[4].timeout.expiry() == 101 && obj_A.advance(100, record) == 0 && wheel::is_scheduled(storage[4]));
+	RA_CHECK(obj_A.advance(101, record) == 2 && fired.size() == 2 && obj_A.now() == 101);
+	RA_CHECK(!wheel::is_scheduled(storage[3]) && !wheel::is_scheduled(storage[4]));
+	wheel::cancel(storage[0]);
+	obj_A.schedule(storage[1], 200);
+	RA_CHECK(obj_A.advance(199, record) == 0);
+	RA_CHECK(obj_A.advance(200, record) == 1 && fired.back() == 1);
+	RA_CHECK(obj_A.advance(4999, record) == 0);
+	RA_CHECK(obj_A.advance(6000, record) == 1 && fired.back() == 2);
+	RA_CHECK(obj_A.advance(2000000, record) == 1 && fired.back() == 5 && obj_A.empty());
+	RA_CHECK(allocs.allocations() == 0);
+	// Destroying a timer cancels it
+	{
+		Connection c(9);
+		obj_A.schedule(c, 2000010);
+		RA_CHECK(!obj_A.empty());
+	}
+	RA_CHECK(obj_A.empty() && obj_A.advance(3000000, record) == 0);
+	// Test random operations against a simple model
+	const int n = 2000;
+	std::vector<std::unique_ptr<Connection>> conns;
+	for(int i=0; i<n; ++i){
+		conns.push_back(std::make_unique<Connection>(i));
+	}
+	std::vector<std::uint64_t> expected(n, 0);
+	std::vector<int> fire_count(n, 0);
+	std::mt19937_64 rng(7);
+	wheel obj_B(12345);
+	std::uint64_t prev = obj_B.now();
+	bool correct = true;
+	bool ordered = true;
+	std::uint64_t last_fired = 0;
+	auto on_fire = [&](Connection& c){
+		std::uint64_t e = expected[c.id];
+		correct = correct && e > prev && e <= obj_B.now();
+		ordered = ordered && e >= last_fired;
+		last_fired = e;
+		expected[c.id] = 0;
+		++fire_count[c.id];
+		// Periodic timers reschedule themselves
+		if(c.id % 5 == 0){
+			expected[c.id] = obj_B.now() + 1 + c.id;
+			obj_B.schedule(c, expected[c.id]);
+		}
+	};
+	std::uint64_t total = 0;
+	for(int step=0; step<2000; ++step){
+		for(int j=0; j<20; ++j){
+			int i = int(rng() % n);
+			std::uint64_t r = rng();
+			if(r % 7 == 0){
+				wheel::cancel(*conns[i]);
+				expected[i] = 0;
+			}
+			else{
+				// Delays of various magnitudes, some past the wheel's range
+				std::uint64_t delay = 1 + (r >> 8) % (std::uint64_t(1) << (r % 15));
+				expected[i] = obj_B.now() + delay;
+				obj_B.schedule(*conns[i], expected[i]);
+			}
+		}
+		prev = obj_B.now();
+		last_fired = 0;
+		std::uint64_t now = prev + rng() % 300;
+		total += obj_B.advance(now, on_fire);
+		for(int i=0; i<n; ++i){
+			bool scheduled = expected[i] != 0;
+			correct = correct && scheduled == wheel::is_scheduled(*conns[i]) && (!scheduled || expected[i] > now);
+		}
+	}
+	RA_CHECK(correct && ordered && total > 0);
+	// Destroying the wheel cancels the remaining timers
+	{
+		wheel obj_C;
+		obj_C.schedule(*conns[0], 10);
+		obj_C.schedule(*conns[1], 100000);
+	}
+	RA_CHECK(!wheel::is_scheduled(*conns[0]) && !wheel::is_scheduled(*conns[1]));
+	cout<<total<<endl;
+	return ra::harness::exit_status();
+}
@@ -0,0 +1,126 @@
+#include"ra/unordered_set.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<cstdint>
+#include<iostream>
+#include<iterator>
+#include<string>
+#include<vector>
+
+namespace ri = ra::intrusive;
+
+struct Session {
+	Session(std::uint64_t id_ = 0, std::string name_ = std::string()) : id(id_), name(name_) {}
+	std::uint64_t id;
+	std::string name;
+	ri::list_hook hook;
+};
+
+// Hashes and compares sessions by id, and accepts ids as keys.
+struct session_hash {
+	using is_transparent = void;
+	std::size_t operator()(const Session& s) const { return std::size_t(s.id); }
+	std::size_t operator()(std::uint64_t id) const { return std::size_t(id); }
+};
+struct session_equal {
+	using is_transparent = void;
+	bool operator()(const Session& x, const Session& y) const { return x.id == y.id; }
+	bool operator()(const Session& x, std::uint64_t id) const { return x.id == id; }
+};
+
+using set_type = ri::unordered_set<Session, &Session::hook, session_hash, session_equal>;
+
+static_assert(std::forward_iterator<set_type::iterator> && std::forward_iterator<set_type::const_iterator>);
+static_assert(sizeof(set_type::bucket_type) == sizeof(ri::list_hook));
+
+// Elements that are their own hooks, with a hash function that puts them
+// all in the same bucket
+struct Flow : ri::list_hook {
+	Flow(int port_) : port(port_) {}
+	int port;
+};
+struct bad_hash {
+	std::size_t operator()(const Flow&) const { return 0; }
+};
+struct flow_equal {
+	bool operator()(const Flow& x, const Flow& y) const { return x.port == y.port; }
+};
+
+int main(){
+	using std::cout;
+	using std::endl;
+	std::vector<Session> storage;
+	for(int i=0; i<100; ++i){
+		storage.push_back(Session(1000 + 8 * i, "session " + std::to_string(i)));
+	}
+	// Test insert, find and erase
+	set_type::bucket_type buckets[16];
+	set_type obj_A(buckets, 16);
+	std::vector<set_type::bucket_type> more(128);
+	std::vector<std::uint64_t> disposed;
+	disposed.reserve(4);
+	RA_CHECK(obj_A.empty() && obj_A.bucket_count() == 16 && obj_A.begin() == obj_A.end());
+	ra::harness::alloc_scope allocs;
+	for(Session& s : storage){
+		RA_CHECK(obj_A.insert(s).second);
+	}
+	RA_CHECK(obj_A.size() == 100 && obj_A.load_factor() > 6.0f);
+	Session dup(1008, "duplicate");
+	std::pair<set_type::iterator, bool> res = obj_A.insert(dup);
+	RA_CHECK(!res.second && &*res.first == &storage[1] && !dup.hook.is_linked());
+	RA_CHECK(obj_A.find(std::uint64_t(1016))->name == "session 2" && obj_A.find(std::uint64_t(1017)) == obj_A.end());
+	RA_CHECK(obj_A.find(Session(1792)) != obj_A.end() && obj_A.contains(std::uint64_t(1792)) && !obj_A.contains(std::uint64_t(1)));
+	RA_CHECK(std::distance(obj_A.begin(), obj_A.end()) == 100);
+	// Every bucket is used
+	int used = 0;
+	for(set_type::bucket_type& b : buckets){
+		used += !b.empty();
+	}
+	RA_CHECK(used == 16);
+	obj_A.erase(storage[0]);
+	RA_CHECK(!storage[0].hook.is_linked() && !obj_A.contains(std::uint64_t(1000)) && obj_A.size() == 99);
+	set_type::iterator next = obj_A.erase(obj_A.iterator_to(storage[1]));
+	RA_CHECK(obj_A.size() == 98 && (next == obj_A.end() || next->id != 1008));
+	auto collect = [&disposed](Session* s) { disposed.push_back(s->id); };
+	RA_CHECK(obj_A.erase_and_dispose(std::uint64_t(1024), collect) == 1);
+	RA_CHECK(obj_A.erase_and_dispose(std::uint64_t(1024), collect) == 0 && disposed.size() == 1);
+	const set_type& cobj_A = obj_A;
+	std::size_t total = 0;
+	for(const Session& s : cobj_A){
+		total += s.id;
+	}
+	RA_CHECK(obj_A.size() == 97 && total == 97 * 1000 + 8 * (99 * 100 / 2 - 4));
+	// Test rehash into a larger bucket array
+	obj_A.rehash(more.data(), more.size());
+	RA_CHECK(obj_A.size() == 97 && obj_A.bucket_count() == 128 && obj_A.buckets() == more.data());
+	bool old_empty = true;
+	for(set_type::bucket_type& b : buckets){
+		old_empty = old_empty && b.empty();
+	}
+	RA_CHECK(old_empty && obj_A.contains(std::uint64_t(1792)) && std::distance(obj_A.begin(), obj_A.end()) == 97);
+	for(Session& s : storage){
+		RA_CHECK(obj_A.contains(s.id) == s.hook.is_linked());
+	}
+	obj_A.clear();
+	RA_CHECK(obj_A.empty() && !storage[50].hook.is_linked());
+	RA_CHECK(allocs.allocations() == 0);
+	// Test base hooks and a hash function that sends everything to one
+	// bucket
+	std::vector<Flow> flows;
+	for(int i=0; i<10; ++i){
+		flows.push_back(Flow(i));
+	}
+	ri::unordered_set<Flow, ri::base_hook, bad_hash, flow_equal>::bucket_type flow_buckets[2];
+	{
+		ri::unordered_set<Flow, ri::base_hook, bad_hash, flow_equal> obj_B(flow_buckets, 2);
+		for(Flow& f : flows){
+			obj_B.insert(f);
+		}
+		RA_CHECK(obj_B.size() == 10 && obj_B.find(Flow(7)) != obj_B.end() && &*obj_B.find(Flow(7)) == &flows[7]);
+		RA_CHECK(flow_buckets[0].size() == 10 && flow_buckets[1].empty());
+	}
+	// Destroying the set unlinks its elements
+	RA_CHECK(flow_buckets[0].empty() && !flows[3].is_linked());
+	cout<<total<<endl;
+	return ra::harness::exit_status();
+}
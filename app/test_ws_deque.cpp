@@ -0,0 +1,132 @@
+#include"ra/ws_deque.hpp"
+#include"alloc_tracker.hpp"
+#include"check.hpp"
+#include<atomic>
+#include<iostream>
+#include<thread>
+#include<vector>
+
+namespace ri = ra::intrusive;
+
+struct Task {
+	Task(int id_ = 0) : id(id_), runs(0) {}
+	Task(const Task& other) : id(other.id), runs(0) {}
+	int id;
+	std::atomic<int> runs;
+	ri::list_hook hook;
+};
+
+using deque = ri::ws_deque<Task, &Task::hook, 8>;
+using tlist = ri::list<Task, &Task::hook>;
+
+int main(){
+	using std::cout;
+	using std::endl;
+	// Test single-threaded push, pop and steal
+	std::vector<Task> storage;
+	for(int i=0; i<20; ++i){
+		storage.push_back(Task(i));
+	}
+	deque obj_A;
+	RA_CHECK(obj_A.empty() && obj_A.pop() == nullptr && obj_A.steal() == nullptr);
+	ra::harness::alloc_scope allocs;
+	for(int i=0; i<5; ++i){
+		obj_A.push(storage[i]);
+	}
+	RA_CHECK(obj_A.size() == 5);
+	RA_CHECK(obj_A.pop() == &storage[4] && obj_A.steal() == &storage[0]);
+	RA_CHECK(obj_A.pop() == &storage[3] && obj_A.steal() == &storage[1]);
+	RA_CHECK(obj_A.pop() == &storage[2] && obj_A.pop() == nullptr && obj_A.steal() == nullptr);
+	// Test overflowing the ring buffer (pops stay LIFO, steals see the
+	// overflowed elements once they are moved back to the ring buffer)
+	for(Task& t : storage){
+		obj_A.push(t);
+	}
+	RA_CHECK(obj_A.size() == 20);
+	RA_CHECK(obj_A.steal() == &storage[0]);
+	bool lifo = true;
+	for(int i=19; i>=14; --i){
+		lifo = lifo && obj_A.pop() == &storage[i];
+	}
+	RA_CHECK(lifo && obj_A.size() == 13);
+	// Test steal_half (thieves see only the 7 elements in the ring buffer)
+	tlist obj_B;
+	RA_CHECK(obj_A.steal_half(obj_B) == 3);
+	RA_CHECK(obj_B.size() == 3 && obj_B.front().id == 1 && obj_B.back().id == 3);
+	bool rest = true;
+	for(int i=13; i>=4; --i){
+		rest = rest && obj_A.pop() == &storage[i];
+	}
+	RA_CHECK(rest && obj_A.empty() && obj_A.pop() == nullptr);
+	obj_B.clear();
+	obj_A.push(storage[7]);
+	RA_CHECK(obj_A.steal_half(obj_B) == 1 && obj_B.size() == 1 && obj_A.empty());
+	obj_B.clear();
+	RA_CHECK(allocs.allocations() == 0);
+	// Test an owner pushing and popping while thieves steal: every task
+	// must be run exactly once
+	const int tasks = 200000;
+	const int thieves = 3;
+	std::vector<Task> work;
+	work.reserve(tasks);
+	for(int i=0; i<tasks; ++i){
+		work.push_back(Task(i));
+	}
+	ri::ws_deque<Task, &Task::hook, 64> obj_C;
+	std::atomic<int> done(0);
+	std::vector<std::thread> threads;
+	std::atomic<int> stolen(0);
+	for(int k=0; k<thieves; ++k){
+		threads.emplace_back([&obj_C, &done, &stolen, k]{
+			tlist batch;
+			while(done.load() < tasks){
+				int n = 0;
+				if(k == 0){
+					n = int(obj_C.steal_half(batch));
+					for(Task& t : batch){
+						t.runs.fetch_add(1);
+					}
+					batch.clear();
+				}
+				else if(Task* t = obj_C.steal()){
+					t->runs.fetch_add(1);
+					n = 1;
+				}
+				if(n){
+					stolen.fetch_add(n);
+					done.fetch_add(n);
+				}
+			}
+		});
+	}
+	int next = 0;
+	while(done.load() < tasks){
+		// Push a burst of tasks (sometimes more than fit in the ring
+		// buffer), then pop a few of them.
+		for(int i=0; i<1 + next % 97 && next < tasks; ++i){
+			obj_C.push(work[next++]);
+		}
+		for(int i=0; i<next % 7; ++i){
+			if(Task* t = obj_C.pop()){
+				t->runs.fetch_add(1);
+				done.fetch_add(1);
+			}
+		}
+		if(next == tasks){
+			while(Task* t = obj_C.pop()){
+				t->runs.fetch_add(1);
+				done.fetch_add(1);
+			}
+		}
+	}
+	for(std::thread& t : threads){
+		t.join();
+	}
+	bool once = true;
+	for(const Task& t : work){
+		once = once && t.runs.load() == 1;
+	}
+	RA_CHECK(once && done.load() == tasks && obj_C.empty());
+	cout<<done.load()<<" "<<(stolen.load() > 0)<<endl;
+	return ra::harness::exit_status();
+}
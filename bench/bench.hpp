@@ -0,0 +1,248 @@
+#ifndef ra_bench_bench_hpp
+#define ra_bench_bench_hpp
+
+/*
+
+Minimal benchmark harness shared by the programs in this directory.
+
+Each program times a set of (container, operation, key type, size)
+cases and prints one result row per case, either as CSV (the default)
+or as a JSON array. Besides the time per operation, each row has the
+number of allocations per operation and, if --perf is given and the
+hardware counters are available, the instructions, cache misses and
+branch misses per operation. The following command-line options are
+understood:
+
+  --format=csv|json   output format
+  --max-size=N        largest container size to benchmark (default 1048576)
+  --max-quadratic=N   largest size for operations that are quadratic for
+                      array-based containers (default 65536)
+  --min-time=S        minimum measured time per case in seconds (default 0.1)
+  --perf              read hardware performance counters
+
+This header includes alloc_tracker.hpp, which replaces the global
+operator new, so it must be included in only one translation unit.
+
+*/
+
+#include<algorithm>
+#include<chrono>
+#include<cstdint>
+#include<cstdlib>
+#include<iostream>
+#include<random>
+#include<string>
+#include<string_view>
+#include<type_traits>
+#include<vector>
+#include"alloc_tracker.hpp"
+#include"perf_counters.hpp"
+
+namespace ra::bench {
+
+	// The sizes exercised by the benchmarks (filtered by --max-size).
+	inline const std::vector<std::size_t> all_sizes = {
+		16, 256, 4096, 65536, 1048576, 16777216, 100000000
+	};
+
+	// Benchmark options parsed from the command line.
+	struct options {
+		bool json = false;
+		std::size_t max_size = 1048576;
+		std::size_t max_quadratic = 65536;
+		double min_time = 0.1;
+		bool perf = false;
+
+		options(int argc, char** argv) {
+			for(int i=1; i<argc; ++i){
+				std::string_view arg(argv[i]);
+				if(arg == "--format=json"){
+					json = true;
+				}
+				else if(arg == "--format=csv"){
+					json = false;
+				}
+				else if(arg.substr(0,11) == "--max-size="){
+					max_size = std::strtoull(argv[i]+11, nullptr, 10);
+				}
+				else if(arg.substr(0,16) == "--max-quadratic="){
+					max_quadratic = std::strtoull(argv[i]+16, nullptr, 10);
+				}
+				else if(arg.substr(0,11) == "--min-time="){
+					min_time = std::strtod(argv[i]+11, nullptr);
+				}
+				else if(arg == "--perf"){
+					perf = true;
+				}
+				else{
+					std::cerr<<"unknown option "<<arg<<"\n";
+					std::exit(2);
+				}
+			}
+		}
+
+		// Returns the benchmark sizes not exceeding limit.
+		std::vector<std::size_t> sizes(std::size_t limit) const {
+			std::vector<std::size_t> result;
+			for(std::size_t n : all_sizes){
+				if(n <= std::min(limit, max_size)){
+					result.push_back(n);
+				}
+			}
+			return result;
+		}
+	};
+
+	// Prevents the compiler from optimizing away the computation of value.
+	template <class T>
+	inline void do_not_optimize(const T& value) {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	// The result of measuring one case (all values per operation).
+	struct result {
+		double ns = 0;
+		std::uint64_t ops = 0;
+		double allocations = 0;
+		double instructions = 0;
+		double cache_misses = 0;
+		double branch_misses = 0;
+	};
+
+	// Collects benchmark results and prints them as CSV or JSON.
+	class reporter {
+		public:
+			explicit reporter(const options& opts) : json_(opts.json), rows_(0) {
+				if(json_){
+					std::cout<<"[\n";
+				}
+				else{
+					std::cout<<"container,operation,key,size,ns_per_op,ops,allocs_per_op,"
+					  "instructions_per_op,cache_misses_per_op,branch_misses_per_op\n";
+				}
+			}
+			reporter(const reporter&) = delete;
+			reporter& operator=(const reporter&) = delete;
+			~reporter() {
+				if(json_){
+					std::cout<<"\n]\n";
+				}
+			}
+
+			void report(std::string_view container, std::string_view operation,
+			  std::string_view key, std::size_t size, const result& r) {
+				if(json_){
+					std::cout<<(rows_ ? ",\n" : "")<<"  {\"container\": \""<<container
+					  <<"\", \"operation\": \""<<operation<<"\", \"key\": \""<<key
+					  <<"\", \"size\": "<<size<<", \"ns_per_op\": "<<r.ns
+					  <<", \"ops\": "<<r.ops<<", \"allocs_per_op\": "<<r.allocations
+					  <<", \"instructions_per_op\": "<<r.instructions
+					  <<", \"cache_misses_per_op\": "<<r.cache_misses
+					  <<", \"branch_misses_per_op\": "<<r.branch_misses<<"}";
+				}
+				else{
+					std::cout<<container<<","<<operation<<","<<key<<","<<size<<","
+					  <<r.ns<<","<<r.ops<<","<<r.allocations<<","<<r.instructions<<","
+					  <<r.cache_misses<<","<<r.branch_misses<<"\n";
+				}
+				++rows_;
+			}
+
+		private:
+			bool json_;
+			std::size_t rows_;
+	};
+
+	// Repeatedly calls run() until at least min_time seconds have been
+	// measured, and returns the averages per operation.
+	// Each call to run() must perform ops_per_run operations. The function
+	// setup() is called (unmeasured) before each call to run().
+	template <class Setup, class Run>
+	result measure(const options& opts, std::uint64_t ops_per_run, Setup setup, Run run) {
+		using clock = std::chrono::steady_clock;
+		static ra::harness::perf_counters counters;
+		const bool perf = opts.perf && counters.available();
+		std::chrono::duration<double> elapsed(0);
+		ra::harness::alloc_counts allocs;
+		ra::harness::perf_readings events;
+		result r;
+		do{
+			setup();
+			ra::harness::alloc_scope scope;
+			if(perf){
+				counters.start();
+			}
+			auto start = clock::now();
+			run();
+			elapsed += clock::now() - start;
+			if(perf){
+				ra::harness::perf_readings e = counters.stop();
+				events.instructions += e.instructions;
+				events.cache_misses += e.cache_misses;
+				events.branch_misses += e.branch_misses;
+			}
+			allocs.allocations += scope.allocations();
+			r.ops += ops_per_run;
+		} while(elapsed.count() < opts.min_time);
+		const double ops = double(r.ops);
+		r.ns = elapsed.count() * 1e9 / ops;
+		r.allocations = double(allocs.allocations) / ops;
+		r.instructions = double(events.instructions) / ops;
+		r.cache_misses = double(events.cache_misses) / ops;
+		r.branch_misses = double(events.branch_misses) / ops;
+		return r;
+	}
+
+	// Key generation.
+	// make_key<K>(i) maps the integer i to a key of type K such that the
+	// order of keys matches the order of i. Benchmarks use even values of
+	// i for keys present in a container and odd values for absent keys.
+	template <class K>
+	inline K make_key(std::uint64_t i) {
+		return K(i);
+	}
+	template <>
+	inline std::string make_key<std::string>(std::uint64_t i) {
+		std::string s = std::to_string(i);
+		return "key:" + std::string(20 - s.size(), '0') + s;
+	}
+
+	template <class K>
+	inline const char* key_name();
+	template <> inline const char* key_name<int>() { return "int"; }
+	template <> inline const char* key_name<std::uint64_t>() { return "uint64"; }
+	template <> inline const char* key_name<std::string>() { return "string"; }
+
+	// Returns the n keys present in a container of size n, in sorted order.
+	template <class K>
+	std::vector<K> sorted_keys(std::size_t n) {
+		std::vector<K> keys;
+		keys.reserve(n);
+		for(std::size_t i=0; i<n; ++i){
+			keys.push_back(make_key<K>(2*i));
+		}
+		return keys;
+	}
+
+	// Returns n keys absent from a container of size n, in random order.
+	template <class K>
+	std::vector<K> missing_keys(std::size_t n, std::uint64_t seed = 2) {
+		std::vector<K> keys;
+		keys.reserve(n);
+		for(std::size_t i=0; i<n; ++i){
+			keys.push_back(make_key<K>(2*i+1));
+		}
+		std::shuffle(keys.begin(), keys.end(), std::mt19937_64(seed));
+		return keys;
+	}
+
+	// Returns a random permutation of the given keys.
+	template <class K>
+	std::vector<K> shuffled(std::vector<K> keys, std::uint64_t seed = 1) {
+		std::shuffle(keys.begin(), keys.end(), std::mt19937_64(seed));
+		return keys;
+	}
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+// Benchmarks ra::intrusive::index_list against ra::intrusive::list for
+// objects that are on four lists at once (so that the hooks make up most
+// of each object), linked in random order.
+
+#include"ra/index_list.hpp"
+#include"ra/intrusive_list.hpp"
+#include"bench.hpp"
+#include<cstdint>
+#include<numeric>
+#include<utility>
+#include<vector>
+
+namespace rb = ra::bench;
+namespace ri = ra::intrusive;
+
+struct pointer_node {
+	std::uint64_t value = 0;
+	ri::list_hook h0, h1, h2, h3;
+};
+struct index_node {
+	std::uint64_t value = 0;
+	ri::index_hook h0, h1, h2, h3;
+};
+
+using plist = ri::list<pointer_node, &pointer_node::h0>;
+using ilist = ri::index_list<index_node, &index_node::h0>;
+
+// The order in which the n objects are linked.
+std::vector<std::size_t> link_order(std::size_t n) {
+	std::vector<std::size_t> order(n);
+	std::iota(order.begin(), order.end(), std::size_t(0));
+	return rb::shuffled(std::move(order));
+}
+
+void run_pointer(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::vector<std::size_t> order = link_order(n);
+	std::vector<pointer_node> nodes(n);
+	plist l;
+	auto fill = [&]{
+		l.clear();
+		for(std::size_t i : order) { l.push_back(nodes[i]); }
+	};
+	rb::result r = rb::measure(opts, n, [&]{ l.clear(); }, fill);
+	out.report("ra::intrusive::list", "push_back", "4_hooks", n, r);
+	fill();
+	std::uint64_t sum = 0;
+	r = rb::measure(opts, n, []{},
+	  [&]{ for(const pointer_node& x : l) { sum += x.value; } });
+	out.report("ra::intrusive::list", "iterate", "4_hooks", n, r);
+	r = rb::measure(opts, n, fill,
+	  [&]{ for(std::size_t i=0; i<n; ++i) { l.erase(l.iterator_to(nodes[i])); } });
+	out.report("ra::intrusive::list", "erase_random", "4_hooks", n, r);
+	rb::do_not_optimize(sum);
+	l.clear();
+}
+
+void run_index(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::vector<std::size_t> order = link_order(n);
+	std::vector<index_node> nodes(n);
+	ri::index_list_head head;
+	ilist l(nodes.data(), head);
+	auto fill = [&]{
+		l.clear();
+		for(std::size_t i : order) { l.push_back(nodes[i]); }
+	};
+	rb::result r = rb::measure(opts, n, [&]{ l.clear(); }, fill);
+	out.report("ra::intrusive::index_list", "push_back", "4_hooks", n, r);
+	fill();
+	std::uint64_t sum = 0;
+	r = rb::measure(opts, n, []{},
+	  [&]{ for(const index_node& x : l) { sum += x.value; } });
+	out.report("ra::intrusive::index_list", "iterate", "4_hooks", n, r);
+	r = rb::measure(opts, n, fill,
+	  [&]{ for(std::size_t i=0; i<n; ++i) { l.erase(nodes[i]); } });
+	out.report("ra::intrusive::index_list", "erase_random", "4_hooks", n, r);
+	rb::do_not_optimize(sum);
+	l.clear();
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	for(std::size_t n : opts.sizes(16777216)){
+		run_pointer(opts, out, n);
+		run_index(opts, out, n);
+	}
+}
@@ -0,0 +1,212 @@
+// Benchmarks ra::intrusive::list against std::list.
+
+#include"ra/intrusive_list.hpp"
+#include"bench.hpp"
+#include<algorithm>
+#include<cstdint>
+#include<iterator>
+#include<list>
+#include<vector>
+
+namespace rb = ra::bench;
+namespace ri = ra::intrusive;
+
+struct node {
+	node(std::uint64_t value_ = 0) : value(value_) {}
+	std::uint64_t value;
+	ri::list_hook hook;
+};
+
+using ilist = ri::list<node, &node::hook>;
+using ilist_nosize = ri::list<node, &node::hook, ra::util::no_stats, false>;
+using slist = std::list<std::uint64_t>;
+
+// Small sizes are processed in batches of lists so that each timed run
+// is long enough to measure.
+inline std::size_t batch_count(std::size_t n) {
+	return std::max<std::size_t>(1, 65536 / n);
+}
+
+void run_intrusive(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::size_t batch = batch_count(n);
+	std::vector<node> nodes;
+	nodes.reserve(batch * n);
+	for(std::size_t i=0; i<batch*n; ++i){
+		nodes.emplace_back(i % n);
+	}
+	// The nodes of each list, in random order.
+	std::vector<node*> order;
+	order.reserve(batch * n);
+	for(std::size_t b=0; b<batch; ++b){
+		std::vector<node*> part;
+		for(std::size_t i=0; i<n; ++i){
+			part.push_back(&nodes[b*n+i]);
+		}
+		part = rb::shuffled(std::move(part));
+		order.insert(order.end(), part.begin(), part.end());
+	}
+	std::vector<ilist> ls(batch);
+	auto clear = [&]{ for(ilist& l : ls) { l.clear(); } };
+	auto fill = [&]{
+		clear();
+		for(std::size_t b=0; b<batch; ++b){
+			for(std::size_t i=0; i<n; ++i) { ls[b].push_back(nodes[b*n+i]); }
+		}
+	};
+	rb::result r;
+
+	r = rb::measure(opts, batch * n, clear, fill);
+	out.report("ra::intrusive::list", "push_back", "uint64", n, r);
+
+	r = rb::measure(opts, batch * n, clear,
+	  [&]{
+		for(std::size_t b=0; b<batch; ++b){
+			for(std::size_t i=0; i<n; ++i) { ls[b].insert(ls[b].begin(), nodes[b*n+i]); }
+		}
+	  });
+	out.report("ra::intrusive::list", "push_front", "uint64", n, r);
+
+	r = rb::measure(opts, batch * n, fill,
+	  [&]{ for(ilist& l : ls) { while(l.size()) { l.erase(l.begin()); } } });
+	out.report("ra::intrusive::list", "erase_front", "uint64", n, r);
+
+	// Tear the lists down, returning every node to a free list (as an
+	// object pool would).
+	std::vector<node*> free_nodes;
+	free_nodes.reserve(batch * n);
+	r = rb::measure(opts, batch * n, [&]{ fill(); free_nodes.clear(); },
+	  [&]{
+		for(ilist& l : ls){
+			l.clear_and_dispose([&free_nodes](node* x) { free_nodes.push_back(x); });
+		}
+	  });
+	out.report("ra::intrusive::list", "teardown", "uint64", n, r);
+
+	r = rb::measure(opts, batch * n, fill,
+	  [&]{
+		for(std::size_t b=0; b<batch; ++b){
+			for(std::size_t i=0; i<n; ++i) { ls[b].erase(ilist::iterator(order[b*n+i])); }
+		}
+	  });
+	out.report("ra::intrusive::list", "erase_random", "uint64", n, r);
+
+	fill();
+	std::uint64_t sum = 0;
+	r = rb::measure(opts, batch * n, []{},
+	  [&]{
+		for(ilist& l : ls){
+			for(ilist::iterator i=l.begin(); i!=l.end(); ++i) { sum += i->value; }
+		}
+	  });
+	out.report("ra::intrusive::list", "iterate", "uint64", n, r);
+	rb::do_not_optimize(sum);
+	clear();
+}
+
+// Splices the second half of each list onto another list (one operation
+// per splice). A list that keeps its size must count the moved elements.
+template <class List>
+void run_splice(const rb::options& opts, rb::reporter& out, std::size_t n, const char* name) {
+	const std::size_t batch = batch_count(n);
+	std::vector<node> nodes(batch * n);
+	std::vector<List> ls(batch);
+	std::vector<List> dst(batch);
+	rb::result r = rb::measure(opts, batch,
+	  [&]{
+		for(std::size_t b=0; b<batch; ++b){
+			ls[b].clear();
+			dst[b].clear();
+			for(std::size_t i=0; i<n; ++i) { ls[b].push_back(nodes[b*n+i]); }
+		}
+	  },
+	  [&]{
+		for(std::size_t b=0; b<batch; ++b){
+			dst[b].splice(dst[b].end(), ls[b], typename List::iterator(&nodes[b*n+n/2]), ls[b].end());
+		}
+	  });
+	out.report(name, "splice_half", "uint64", n, r);
+	for(std::size_t b=0; b<batch; ++b){
+		ls[b].clear();
+		dst[b].clear();
+	}
+}
+
+void run_std(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::size_t batch = batch_count(n);
+	std::vector<slist> ls(batch);
+	std::vector<slist::iterator> order;
+	auto clear = [&]{ for(slist& l : ls) { l.clear(); } };
+	auto fill = [&]{
+		for(slist& l : ls){
+			l.clear();
+			for(std::size_t i=0; i<n; ++i) { l.push_back(i); }
+		}
+	};
+	rb::result r;
+
+	r = rb::measure(opts, batch * n, clear, fill);
+	out.report("std::list", "push_back", "uint64", n, r);
+
+	r = rb::measure(opts, batch * n, clear,
+	  [&]{ for(slist& l : ls) { for(std::size_t i=0; i<n; ++i) { l.push_front(i); } } });
+	out.report("std::list", "push_front", "uint64", n, r);
+
+	r = rb::measure(opts, batch * n, fill,
+	  [&]{ for(slist& l : ls) { while(!l.empty()) { l.erase(l.begin()); } } });
+	out.report("std::list", "erase_front", "uint64", n, r);
+
+	r = rb::measure(opts, batch * n, fill,
+	  [&]{ for(slist& l : ls) { l.clear(); } });
+	out.report("std::list", "teardown", "uint64", n, r);
+
+	r = rb::measure(opts, batch * n,
+	  [&]{
+		fill();
+		order.clear();
+		for(slist& l : ls){
+			std::vector<slist::iterator> part;
+			for(auto i=l.begin(); i!=l.end(); ++i) { part.push_back(i); }
+			part = rb::shuffled(std::move(part));
+			order.insert(order.end(), part.begin(), part.end());
+		}
+	  },
+	  [&]{
+		for(std::size_t b=0; b<batch; ++b){
+			for(std::size_t i=0; i<n; ++i) { ls[b].erase(order[b*n+i]); }
+		}
+	  });
+	out.report("std::list", "erase_random", "uint64", n, r);
+
+	fill();
+	std::uint64_t sum = 0;
+	r = rb::measure(opts, batch * n, []{},
+	  [&]{ for(slist& l : ls) { for(std::uint64_t v : l) { sum += v; } } });
+	out.report("std::list", "iterate", "uint64", n, r);
+	rb::do_not_optimize(sum);
+
+	std::vector<slist> dst(batch);
+	std::vector<slist::iterator> mid(batch);
+	r = rb::measure(opts, batch,
+	  [&]{
+		fill();
+		for(std::size_t b=0; b<batch; ++b){
+			dst[b].clear();
+			mid[b] = std::next(ls[b].begin(), n / 2);
+		}
+	  },
+	  [&]{
+		for(std::size_t b=0; b<batch; ++b) { dst[b].splice(dst[b].end(), ls[b], mid[b], ls[b].end()); }
+	  });
+	out.report("std::list", "splice_half", "uint64", n, r);
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	for(std::size_t n : opts.sizes(100000000)){
+		run_intrusive(opts, out, n);
+		run_splice<ilist>(opts, out, n, "ra::intrusive::list");
+		run_splice<ilist_nosize>(opts, out, n, "ra::intrusive::list(no size)");
+		run_std(opts, out, n);
+	}
+}
@@ -0,0 +1,91 @@
+// Benchmarks ra::intrusive::multiset against a std::multiset of pointers
+// to the same objects (which allocates a node per element), as an index
+// of orders by price.
+
+#include"ra/intrusive_set.hpp"
+#include"bench.hpp"
+#include<cstdint>
+#include<numeric>
+#include<set>
+#include<utility>
+#include<vector>
+
+namespace rb = ra::bench;
+namespace ri = ra::intrusive;
+
+struct order;
+struct order_ptr_less {
+	using is_transparent = void;
+	bool operator()(const order* x, const order* y) const;
+	bool operator()(const order* x, std::uint64_t price) const;
+	bool operator()(std::uint64_t price, const order* y) const;
+};
+using sindex = std::multiset<order*, order_ptr_less>;
+
+struct order {
+	std::uint64_t price = 0;
+	std::uint64_t quantity = 1;
+	ri::set_hook hook;
+	sindex::iterator pos;
+};
+
+bool order_ptr_less::operator()(const order* x, const order* y) const { return x->price < y->price; }
+bool order_ptr_less::operator()(const order* x, std::uint64_t price) const { return x->price < price; }
+bool order_ptr_less::operator()(std::uint64_t price, const order* y) const { return price < y->price; }
+
+struct order_less {
+	using is_transparent = void;
+	bool operator()(const order& x, const order& y) const { return x.price < y.price; }
+	bool operator()(const order& x, std::uint64_t price) const { return x.price < price; }
+	bool operator()(std::uint64_t price, const order& y) const { return price < y.price; }
+};
+using iindex = ri::multiset<order, &order::hook, order_less>;
+
+// Each case inserts n orders (in random price order) into an empty index,
+// looks up n prices (lower_bound), or erases the n orders (given the
+// orders themselves, in random order).
+void run(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::vector<std::uint64_t> prices = rb::shuffled(rb::sorted_keys<std::uint64_t>(n));
+	std::vector<order> orders(n);
+	for(std::size_t i=0; i<n; ++i){
+		orders[i].price = prices[i];
+	}
+	std::vector<std::size_t> erase_order(n);
+	std::iota(erase_order.begin(), erase_order.end(), std::size_t(0));
+	erase_order = rb::shuffled(std::move(erase_order));
+	std::uint64_t sum = 0;
+	rb::result r;
+	{
+		iindex s;
+		r = rb::measure(opts, n, [&]{ s.clear(); },
+		  [&]{ for(order& o : orders) { s.insert(o); } });
+		out.report("ra::intrusive::multiset", "insert", "uint64", n, r);
+		r = rb::measure(opts, n, []{},
+		  [&]{ for(std::uint64_t p : prices) { sum += s.lower_bound(p)->quantity; } });
+		out.report("ra::intrusive::multiset", "lower_bound", "uint64", n, r);
+		r = rb::measure(opts, n, [&]{ s.clear(); for(order& o : orders) { s.insert(o); } },
+		  [&]{ for(std::size_t i : erase_order) { s.erase(orders[i]); } });
+		out.report("ra::intrusive::multiset", "erase", "uint64", n, r);
+	}
+	{
+		sindex s;
+		r = rb::measure(opts, n, [&]{ s.clear(); },
+		  [&]{ for(order& o : orders) { o.pos = s.insert(&o); } });
+		out.report("std::multiset<T*>", "insert", "uint64", n, r);
+		r = rb::measure(opts, n, []{},
+		  [&]{ for(std::uint64_t p : prices) { sum += (*s.lower_bound(p))->quantity; } });
+		out.report("std::multiset<T*>", "lower_bound", "uint64", n, r);
+		r = rb::measure(opts, n, [&]{ s.clear(); for(order& o : orders) { o.pos = s.insert(&o); } },
+		  [&]{ for(std::size_t i : erase_order) { s.erase(orders[i].pos); } });
+		out.report("std::multiset<T*>", "erase", "uint64", n, r);
+	}
+	rb::do_not_optimize(sum);
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	for(std::size_t n : opts.sizes(16777216)){
+		run(opts, out, n);
+	}
+}
@@ -0,0 +1,117 @@
+// Benchmarks ra::intrusive::lru_cache against the usual LRU cache built
+// from a std::list of entries and a std::unordered_map of list iterators.
+
+#include"ra/lru_cache.hpp"
+#include"bench.hpp"
+#include<cstdint>
+#include<list>
+#include<unordered_map>
+#include<vector>
+
+namespace rb = ra::bench;
+namespace ri = ra::intrusive;
+
+struct entry {
+	std::uint64_t key = 0;
+	std::uint64_t value = 0;
+	ri::list_hook lru_hook;
+	ri::list_hook hash_hook;
+};
+
+using icache = ri::lru_cache<entry, &entry::key, &entry::lru_hook, &entry::hash_hook>;
+
+// A std::list plus std::unordered_map LRU cache.
+class std_cache {
+	public:
+		explicit std_cache(std::size_t capacity) : capacity_(capacity) { index_.reserve(capacity); }
+		std::uint64_t* get(std::uint64_t key) {
+			auto i = index_.find(key);
+			if(i == index_.end()){
+				return nullptr;
+			}
+			order_.splice(order_.begin(), order_, i->second);
+			return &i->second->second;
+		}
+		void insert(std::uint64_t key, std::uint64_t value) {
+			order_.emplace_front(key, value);
+			index_.emplace(key, order_.begin());
+			if(order_.size() > capacity_){
+				index_.erase(order_.back().first);
+				order_.pop_back();
+			}
+		}
+	private:
+		using list_type = std::list<std::pair<std::uint64_t, std::uint64_t>>;
+		std::size_t capacity_;
+		list_type order_;
+		std::unordered_map<std::uint64_t, list_type::iterator> index_;
+};
+
+// Each case looks up n keys (in random order) in a cache of capacity n
+// holding keys 0 to n-1 (get_hit), or inserts n new keys, each evicting
+// the least recently used entry (insert_evict).
+void run(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::vector<std::uint64_t> keys = rb::shuffled(rb::sorted_keys<std::uint64_t>(n));
+	std::uint64_t sum = 0;
+	rb::result r;
+	{
+		std::vector<entry> entries(2 * n);
+		for(std::size_t i=0; i<2*n; ++i){
+			entries[i].key = 2 * i;
+			entries[i].value = i;
+		}
+		icache c(n);
+		std::vector<entry*> free_entries;
+		free_entries.reserve(2 * n);
+		auto dispose = [&free_entries](entry* e) { free_entries.push_back(e); };
+		for(std::size_t i=0; i<n; ++i){
+			c.insert(entries[i], dispose);
+		}
+		for(std::size_t i=n; i<2*n; ++i){
+			free_entries.push_back(&entries[i]);
+		}
+		r = rb::measure(opts, n, []{},
+		  [&]{ for(std::uint64_t k : keys) { sum += c.get(k)->value; } });
+		out.report("ra::intrusive::lru_cache", "get_hit", "uint64", n, r);
+		std::uint64_t next_key = 4 * n;
+		r = rb::measure(opts, n, []{},
+		  [&]{
+			for(std::size_t i=0; i<n; ++i){
+				entry* e = free_entries.back();
+				free_entries.pop_back();
+				e->key = next_key;
+				next_key += 2;
+				c.insert(*e, dispose);
+			}
+		  });
+		out.report("ra::intrusive::lru_cache", "insert_evict", "uint64", n, r);
+		c.clear_and_dispose([](entry*) {});
+	}
+	{
+		std_cache c(n);
+		for(std::size_t i=0; i<n; ++i){
+			c.insert(2 * i, i);
+		}
+		r = rb::measure(opts, n, []{},
+		  [&]{ for(std::uint64_t k : keys) { sum += *c.get(k); } });
+		out.report("std::list+std::unordered_map", "get_hit", "uint64", n, r);
+		std::uint64_t next_key = 4 * n;
+		r = rb::measure(opts, n, []{},
+		  [&]{
+			for(std::size_t i=0; i<n; ++i){
+				c.insert(next_key, i);
+				next_key += 2;
+			}
+		  });
+		out.report("std::list+std::unordered_map", "insert_evict", "uint64", n, r);
+	}
+	rb::do_not_optimize(sum);
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	for(std::size_t n : opts.sizes(16777216)){
+		run(opts, out, n);
+	}
+}
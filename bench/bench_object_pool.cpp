@@ -0,0 +1,64 @@
+// Benchmarks ra::intrusive::object_pool against allocating each object
+// with new and delete.
+
+#include"ra/object_pool.hpp"
+#include"bench.hpp"
+#include<cstdint>
+#include<memory>
+#include<vector>
+
+namespace rb = ra::bench;
+namespace ri = ra::intrusive;
+
+struct node {
+	std::uint64_t value = 0;
+	ri::list_hook hook;
+};
+
+using ilist = ri::list<node, &node::hook>;
+
+// Each case acquires n objects, putting them on a list (as in use), and
+// then releases them all; an operation is one acquire and one release.
+template <class Acquire, class Release>
+void run_case(const rb::options& opts, rb::reporter& out, const char* name, std::size_t n,
+  Acquire acquire, Release release) {
+	ilist in_use;
+	rb::result r = rb::measure(opts, n, []{},
+	  [&]{
+		for(std::size_t i=0; i<n; ++i){
+			node& x = acquire();
+			x.value = i;
+			in_use.push_back(x);
+		}
+		in_use.clear_and_dispose(release);
+	  });
+	out.report(name, "acquire_release", "node", n, r);
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	for(std::size_t n : opts.sizes(16777216)){
+		run_case(opts, out, "new/delete", n,
+		  []() -> node& { return *new node; }, [](node* x) { delete x; });
+		{
+			ri::object_pool<node, &node::hook> pool(4096);
+			pool.reserve(n);
+			run_case(opts, out, "object_pool<std::mutex>", n,
+			  [&pool]() -> node& { return pool.acquire(); }, [&pool](node* x) { pool.release(*x); });
+		}
+		{
+			ri::object_pool<node, &node::hook, ri::null_mutex> pool(4096);
+			pool.reserve(n);
+			run_case(opts, out, "object_pool<null_mutex>", n,
+			  [&pool]() -> node& { return pool.acquire(); }, [&pool](node* x) { pool.release(*x); });
+		}
+		{
+			ri::object_pool<node, &node::hook> pool(4096);
+			pool.reserve(n);
+			ri::object_pool<node, &node::hook>::cache cache(pool);
+			run_case(opts, out, "object_pool::cache", n,
+			  [&cache]() -> node& { return cache.acquire(); }, [&cache](node* x) { cache.release(*x); });
+		}
+	}
+}
@@ -0,0 +1,144 @@
+// Benchmarks sv_set against std::set, std::unordered_set and a sorted
+// std::vector searched with std::lower_bound.
+
+#include"ra/sv_set.hpp"
+#include"bench.hpp"
+#include<algorithm>
+#include<cstdint>
+#include<set>
+#include<string>
+#include<unordered_set>
+#include<vector>
+
+namespace rb = ra::bench;
+
+// Adapters giving the benchmarked containers a common interface.
+template <class K>
+struct sv_set_adapter {
+	using type = ra::container::sv_set<K>;
+	static constexpr const char* name = "sv_set";
+	static constexpr bool quadratic = true;
+	static void insert(type& c, const K& k) { c.insert(k); }
+	static void bulk(type& c, const std::vector<K>& sorted) {
+		c = type(typename type::ordered_and_unique_range(), sorted.data(), sorted.size());
+	}
+	static bool contains(const type& c, const K& k) { return c.find(k) != c.end(); }
+	static void erase(type& c, const K& k) { c.erase(c.find(k)); }
+};
+
+template <class K>
+struct set_adapter {
+	using type = std::set<K>;
+	static constexpr const char* name = "std::set";
+	static constexpr bool quadratic = false;
+	static void insert(type& c, const K& k) { c.insert(k); }
+	static void bulk(type& c, const std::vector<K>& sorted) { c = type(sorted.begin(), sorted.end()); }
+	static bool contains(const type& c, const K& k) { return c.find(k) != c.end(); }
+	static void erase(type& c, const K& k) { c.erase(k); }
+};
+
+template <class K>
+struct unordered_set_adapter {
+	using type = std::unordered_set<K>;
+	static constexpr const char* name = "std::unordered_set";
+	static constexpr bool quadratic = false;
+	static void insert(type& c, const K& k) { c.insert(k); }
+	static void bulk(type& c, const std::vector<K>& sorted) { c = type(sorted.begin(), sorted.end(), sorted.size()); }
+	static bool contains(const type& c, const K& k) { return c.find(k) != c.end(); }
+	static void erase(type& c, const K& k) { c.erase(k); }
+};
+
+template <class K>
+struct sorted_vector_adapter {
+	using type = std::vector<K>;
+	static constexpr const char* name = "sorted_vector";
+	static constexpr bool quadratic = true;
+	static void insert(type& c, const K& k) {
+		auto pos = std::lower_bound(c.begin(), c.end(), k);
+		if(pos == c.end() || k < *pos){
+			c.insert(pos, k);
+		}
+	}
+	static void bulk(type& c, const std::vector<K>& sorted) { c.assign(sorted.begin(), sorted.end()); }
+	static bool contains(const type& c, const K& k) {
+		auto pos = std::lower_bound(c.begin(), c.end(), k);
+		return pos != c.end() && !(k < *pos);
+	}
+	static void erase(type& c, const K& k) { c.erase(std::lower_bound(c.begin(), c.end(), k)); }
+};
+
+template <class K>
+inline std::uint64_t weight(const K& k) { return std::uint64_t(k); }
+inline std::uint64_t weight(const std::string& k) { return k.size(); }
+
+// Runs all operations for one container adapter, key type and size.
+template <template <class> class Adapter, class K>
+void run_case(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	using A = Adapter<K>;
+	using C = typename A::type;
+	const std::vector<K> sorted = rb::sorted_keys<K>(n);
+	const std::vector<K> hits = rb::shuffled(sorted);
+	const std::vector<K> misses = rb::missing_keys<K>(n);
+	// Small sizes are processed in batches of containers so that each
+	// timed run is long enough to measure.
+	const std::size_t batch = std::max<std::size_t>(1, 65536 / n);
+	std::vector<C> cs(batch);
+	rb::result r;
+
+	if(!A::quadratic || n <= opts.max_quadratic){
+		r = rb::measure(opts, batch * n,
+		  [&]{ for(C& c : cs) { c = C(); } },
+		  [&]{ for(C& c : cs) { for(const K& k : hits) { A::insert(c, k); } } });
+		out.report(A::name, "insert", rb::key_name<K>(), n, r);
+	}
+
+	r = rb::measure(opts, batch * n,
+	  [&]{ for(C& c : cs) { c = C(); } },
+	  [&]{ for(C& c : cs) { A::bulk(c, sorted); } });
+	out.report(A::name, "bulk_build", rb::key_name<K>(), n, r);
+
+	C& c0 = cs.front();
+	std::uint64_t found = 0;
+	r = rb::measure(opts, batch * n, []{},
+	  [&]{ for(std::size_t b=0; b<batch; ++b) { for(const K& k : hits) { found += A::contains(c0, k); } } });
+	out.report(A::name, "find_hit", rb::key_name<K>(), n, r);
+
+	r = rb::measure(opts, batch * n, []{},
+	  [&]{ for(std::size_t b=0; b<batch; ++b) { for(const K& k : misses) { found += A::contains(c0, k); } } });
+	out.report(A::name, "find_miss", rb::key_name<K>(), n, r);
+	rb::do_not_optimize(found);
+
+	std::uint64_t sum = 0;
+	r = rb::measure(opts, batch * n, []{},
+	  [&]{ for(std::size_t b=0; b<batch; ++b) { for(const K& k : c0) { sum += weight(k); } } });
+	out.report(A::name, "iterate", rb::key_name<K>(), n, r);
+	rb::do_not_optimize(sum);
+
+	if(!A::quadratic || n <= opts.max_quadratic){
+		r = rb::measure(opts, batch * n,
+		  [&]{ for(C& c : cs) { A::bulk(c, sorted); } },
+		  [&]{ for(C& c : cs) { for(const K& k : hits) { A::erase(c, k); } } });
+		out.report(A::name, "erase", rb::key_name<K>(), n, r);
+	}
+}
+
+template <class K>
+void run_key(const rb::options& opts, rb::reporter& out) {
+	// String keys take several times more memory than integers, so
+	// they are limited to smaller sizes.
+	const std::size_t limit = std::is_same_v<K, std::string> ? 16777216 : 100000000;
+	for(std::size_t n : opts.sizes(limit)){
+		run_case<sv_set_adapter, K>(opts, out, n);
+		run_case<set_adapter, K>(opts, out, n);
+		run_case<unordered_set_adapter, K>(opts, out, n);
+		run_case<sorted_vector_adapter, K>(opts, out, n);
+	}
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	run_key<int>(opts, out);
+	run_key<std::uint64_t>(opts, out);
+	run_key<std::string>(opts, out);
+}
@@ -0,0 +1,106 @@
+// Benchmarks ra::intrusive::timer_wheel against timers kept in a
+// std::multimap ordered by expiry time (a balanced tree, which has the
+// same O(log n) costs as a heap but also supports cancellation).
+
+#include"ra/timer_wheel.hpp"
+#include"bench.hpp"
+#include<cstdint>
+#include<map>
+#include<random>
+#include<vector>
+
+namespace rb = ra::bench;
+namespace ri = ra::intrusive;
+
+// The timeouts used by the benchmarks (in ticks, e.g., milliseconds): up
+// to about a minute, as for connection timeouts.
+std::vector<std::uint64_t> make_delays(std::size_t n) {
+	std::mt19937_64 rng(3);
+	std::vector<std::uint64_t> delays(n);
+	for(std::uint64_t& d : delays){
+		d = 1000 + rng() % 60000;
+	}
+	return delays;
+}
+
+struct wheel_timer {
+	std::uint64_t fired = 0;
+	ri::timer_hook hook;
+};
+using wheel = ri::timer_wheel<wheel_timer, &wheel_timer::hook>;
+
+struct map_timer;
+using timer_map = std::multimap<std::uint64_t, map_timer*>;
+struct map_timer {
+	std::uint64_t fired = 0;
+	timer_map::iterator pos;
+};
+
+void run_wheel(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::vector<std::uint64_t> delays = make_delays(n);
+	std::vector<wheel_timer> timers(n);
+	wheel w;
+	rb::result r;
+
+	r = rb::measure(opts, n, [&]{ for(wheel_timer& t : timers) { wheel::cancel(t); } },
+	  [&]{ for(std::size_t i=0; i<n; ++i) { w.schedule(timers[i], w.now() + delays[i]); } });
+	out.report("ra::intrusive::timer_wheel", "schedule", "timer", n, r);
+
+	// Reschedule every timer (as on the arrival of a packet).
+	std::size_t shift = 0;
+	r = rb::measure(opts, n, [&]{ ++shift; },
+	  [&]{ for(std::size_t i=0; i<n; ++i) { w.schedule(timers[i], w.now() + delays[(i + shift) % n]); } });
+	out.report("ra::intrusive::timer_wheel", "reschedule", "timer", n, r);
+
+	r = rb::measure(opts, n,
+	  [&]{ for(std::size_t i=0; i<n; ++i) { w.schedule(timers[i], w.now() + delays[i]); } },
+	  [&]{ w.advance(w.now() + 61000, [](wheel_timer& t) { ++t.fired; }); });
+	out.report("ra::intrusive::timer_wheel", "expire_all", "timer", n, r);
+}
+
+void run_map(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::vector<std::uint64_t> delays = make_delays(n);
+	std::vector<map_timer> timers(n);
+	timer_map m;
+	std::uint64_t now = 0;
+	rb::result r;
+
+	r = rb::measure(opts, n, [&]{ m.clear(); },
+	  [&]{
+		for(std::size_t i=0; i<n; ++i) { timers[i].pos = m.emplace(now + delays[i], &timers[i]); }
+	  });
+	out.report("std::multimap", "schedule", "timer", n, r);
+
+	std::size_t shift = 0;
+	r = rb::measure(opts, n, [&]{ ++shift; },
+	  [&]{
+		for(std::size_t i=0; i<n; ++i){
+			m.erase(timers[i].pos);
+			timers[i].pos = m.emplace(now + delays[(i + shift) % n], &timers[i]);
+		}
+	  });
+	out.report("std::multimap", "reschedule", "timer", n, r);
+
+	r = rb::measure(opts, n,
+	  [&]{
+		m.clear();
+		for(std::size_t i=0; i<n; ++i) { timers[i].pos = m.emplace(now + delays[i], &timers[i]); }
+	  },
+	  [&]{
+		now += 61000;
+		while(!m.empty() && m.begin()->first <= now){
+			++m.begin()->second->fired;
+			m.erase(m.begin());
+		}
+	  });
+	out.report("std::multimap", "expire_all", "timer", n, r);
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	for(std::size_t n : opts.sizes(16777216)){
+		run_wheel(opts, out, n);
+		run_map(opts, out, n);
+	}
+}
@@ -0,0 +1,88 @@
+// Benchmarks ra::intrusive::unordered_set against a std::unordered_set of
+// pointers to the same objects (which allocates a node per element).
+
+#include"ra/unordered_set.hpp"
+#include"bench.hpp"
+#include<cstdint>
+#include<unordered_set>
+#include<vector>
+
+namespace rb = ra::bench;
+namespace ri = ra::intrusive;
+
+struct flow {
+	std::uint64_t key = 0;
+	std::uint64_t packets = 0;
+	ri::list_hook hook;
+};
+
+// Hashes and compares flows (or pointers to them) by key, and accepts keys
+// for lookups.
+struct flow_hash {
+	using is_transparent = void;
+	std::size_t operator()(const flow& f) const { return std::size_t(f.key); }
+	std::size_t operator()(const flow* f) const { return std::size_t(f->key); }
+	std::size_t operator()(std::uint64_t k) const { return std::size_t(k); }
+};
+struct flow_equal {
+	using is_transparent = void;
+	bool operator()(const flow& x, const flow& y) const { return x.key == y.key; }
+	bool operator()(const flow& x, std::uint64_t k) const { return x.key == k; }
+	bool operator()(const flow* x, const flow* y) const { return x->key == y->key; }
+	bool operator()(const flow* x, std::uint64_t k) const { return x->key == k; }
+	bool operator()(std::uint64_t k, const flow* x) const { return x->key == k; }
+};
+
+using iset = ri::unordered_set<flow, &flow::hook, flow_hash, flow_equal>;
+using sset = std::unordered_set<flow*, flow_hash, flow_equal>;
+
+// Each case inserts n flows into an empty set, looks up their n keys in
+// random order (find_hit), or erases the n flows.
+void run(const rb::options& opts, rb::reporter& out, std::size_t n) {
+	const std::vector<std::uint64_t> keys = rb::shuffled(rb::sorted_keys<std::uint64_t>(n));
+	std::vector<flow> flows(n);
+	for(std::size_t i=0; i<n; ++i){
+		flows[i].key = keys[i];
+	}
+	std::uint64_t sum = 0;
+	rb::result r;
+	{
+		std::size_t bucket_count = 2;
+		while(bucket_count < n){
+			bucket_count *= 2;
+		}
+		std::vector<iset::bucket_type> buckets(bucket_count);
+		iset s(buckets.data(), buckets.size());
+		r = rb::measure(opts, n, [&]{ s.clear(); },
+		  [&]{ for(flow& f : flows) { s.insert(f); } });
+		out.report("ra::intrusive::unordered_set", "insert", "uint64", n, r);
+		r = rb::measure(opts, n, []{},
+		  [&]{ for(std::uint64_t k : keys) { sum += s.find(k)->packets; } });
+		out.report("ra::intrusive::unordered_set", "find_hit", "uint64", n, r);
+		r = rb::measure(opts, n, [&]{ s.clear(); for(flow& f : flows) { s.insert(f); } },
+		  [&]{ for(flow& f : flows) { s.erase(f); } });
+		out.report("ra::intrusive::unordered_set", "erase", "uint64", n, r);
+	}
+	{
+		sset s;
+		s.reserve(n);
+		r = rb::measure(opts, n, [&]{ s.clear(); },
+		  [&]{ for(flow& f : flows) { s.insert(&f); } });
+		out.report("std::unordered_set<T*>", "insert", "uint64", n, r);
+		r = rb::measure(opts, n, []{},
+		  [&]{ for(std::uint64_t k : keys) { sum += (*s.find(k))->packets; } });
+		out.report("std::unordered_set<T*>", "find_hit", "uint64", n, r);
+		r = rb::measure(opts, n, [&]{ s.clear(); for(flow& f : flows) { s.insert(&f); } },
+		  [&]{ for(flow& f : flows) { s.erase(&f); } });
+		out.report("std::unordered_set<T*>", "erase", "uint64", n, r);
+	}
+	rb::do_not_optimize(sum);
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	for(std::size_t n : opts.sizes(16777216)){
+		run(opts, out, n);
+	}
+}
@@ -0,0 +1,152 @@
+// Benchmarks a work-stealing scheduler built on ra::intrusive::ws_deque
+// against one built on per-worker ra::intrusive::list objects guarded by
+// spin locks, for increasing numbers of worker threads.
+// The workload is a binary tree of tasks: the task with index i spawns
+// the tasks 2i+1 and 2i+2 (if they exist), so work starts on one worker
+// and must be stolen by the others.
+
+#include"ra/ws_deque.hpp"
+#include"bench.hpp"
+#include<atomic>
+#include<cstdint>
+#include<memory>
+#include<string>
+#include<thread>
+#include<vector>
+
+namespace rb = ra::bench;
+namespace ri = ra::intrusive;
+
+struct task {
+	std::uint64_t id;
+	ri::list_hook hook;
+};
+
+using tlist = ri::list<task, &task::hook>;
+using tdeque = ri::ws_deque<task, &task::hook>;
+
+// A test-and-test-and-set spin lock.
+class spin_lock {
+	public:
+		void lock() noexcept {
+			while(locked_.exchange(true, std::memory_order_acquire)){
+				while(locked_.load(std::memory_order_relaxed)){
+				}
+			}
+		}
+		void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+	private:
+		std::atomic<bool> locked_{false};
+};
+
+// The baseline per-worker task list.
+struct alignas(64) locked_list {
+	spin_lock lock;
+	tlist tasks;
+	void push(task& t) { lock.lock(); tasks.push_back(t); lock.unlock(); }
+	task* pop() { return take(false); }
+	task* steal() { return take(true); }
+	task* take(bool front) {
+		lock.lock();
+		task* t = nullptr;
+		if(tasks.size()){
+			t = front ? &tasks.front() : &tasks.back();
+			front ? tasks.pop_front() : tasks.pop_back();
+		}
+		lock.unlock();
+		return t;
+	}
+};
+
+// Runs all n tasks on the given per-worker queues (one thread each),
+// starting from the task 0 in the first queue.
+template <class Queue>
+void run_tree(std::vector<task>& tasks, Queue* queues, std::size_t workers) {
+	const std::uint64_t n = tasks.size();
+	std::atomic<std::uint64_t> remaining(n);
+	std::atomic<std::uint64_t> checksum(0);
+	queues[0].push(tasks[0]);
+	auto work = [&](std::size_t w){
+		Queue& own = queues[w];
+		std::uint64_t state = w * 0x9e3779b97f4a7c15u + 1;
+		std::uint64_t sum = 0;
+		std::uint64_t done = 0;
+		while(remaining.load(std::memory_order_relaxed) != 0){
+			task* t = own.pop();
+			if(!t && workers > 1){
+				state ^= state << 13;
+				state ^= state >> 7;
+				state ^= state << 17;
+				std::size_t victim = state % workers;
+				if(victim != w){
+					t = queues[victim].steal();
+				}
+			}
+			if(!t){
+				// Publish progress while idle, so the workers can see that
+				// all tasks have run.
+				if(done){
+					remaining.fetch_sub(done, std::memory_order_relaxed);
+					done = 0;
+				}
+				continue;
+			}
+			sum += t->id * 0xff51afd7ed558ccdu;
+			for(std::uint64_t c=2*t->id+1; c<=2*t->id+2 && c<n; ++c){
+				own.push(tasks[c]);
+			}
+			if(++done == 64){
+				remaining.fetch_sub(done, std::memory_order_relaxed);
+				done = 0;
+			}
+		}
+		checksum.fetch_add(sum, std::memory_order_relaxed);
+	};
+	std::vector<std::thread> threads;
+	for(std::size_t w=1; w<workers; ++w){
+		threads.emplace_back(work, w);
+	}
+	work(0);
+	for(std::thread& t : threads){
+		t.join();
+	}
+	rb::do_not_optimize(checksum.load());
+}
+
+// Returns 1, 2, 4, ... up to the number of hardware threads (and that
+// number itself).
+std::vector<std::size_t> worker_counts() {
+	std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<std::size_t> result;
+	for(std::size_t w=1; w<hw; w*=2){
+		result.push_back(w);
+	}
+	result.push_back(hw);
+	return result;
+}
+
+int main(int argc, char** argv) {
+	rb::options opts(argc, argv);
+	rb::reporter out(opts);
+	for(std::size_t n : opts.sizes(16777216)){
+		if(n < 65536){
+			// Too little work to amortize starting the threads.
+			continue;
+		}
+		std::vector<task> tasks(n);
+		for(std::size_t i=0; i<n; ++i){
+			tasks[i].id = i;
+		}
+		for(std::size_t workers : worker_counts()){
+			const std::string key = std::to_string(workers) + "_threads";
+			std::unique_ptr<tdeque[]> deques(new tdeque[workers]);
+			rb::result r = rb::measure(opts, n, []{},
+			  [&]{ run_tree(tasks, deques.get(), workers); });
+			out.report("ra::intrusive::ws_deque", "spawn_run", key, n, r);
+			std::unique_ptr<locked_list[]> lists(new locked_list[workers]);
+			r = rb::measure(opts, n, []{},
+			  [&]{ run_tree(tasks, lists.get(), workers); });
+			out.report("spin_lock+ra::intrusive::list", "spawn_run", key, n, r);
+		}
+	}
+}
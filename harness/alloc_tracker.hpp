@@ -0,0 +1,140 @@
+#ifndef ra_harness_alloc_tracker_hpp
+#define ra_harness_alloc_tracker_hpp
+
+/*
+
+Allocation counting for test and benchmark programs.
+
+This header replaces the global operator new and operator delete (all
+of the usual, array, aligned and nothrow forms) with versions that
+count, for the calling thread, the number of allocations and
+deallocations and the number of bytes allocated. It must be included
+in exactly one translation unit of a program.
+
+An alloc_scope records the counts at its construction, and its counts()
+member returns what the calling thread has allocated since then.
+
+*/
+
+#include<cstddef>
+#include<cstdint>
+#include<cstdlib>
+#include<new>
+
+namespace ra::harness {
+
+	// Allocation counts (for one thread).
+	struct alloc_counts {
+		std::uint64_t allocations = 0;
+		std::uint64_t deallocations = 0;
+		std::uint64_t bytes_allocated = 0;
+	};
+
+	namespace detail {
+		inline thread_local alloc_counts thread_counts;
+
+		inline void* allocate(std::size_t size, std::size_t alignment) noexcept {
+			if(size == 0){
+				size = 1;
+			}
+			void* p;
+			if(alignment <= alignof(std::max_align_t)){
+				p = std::malloc(size);
+			}
+			else if(::posix_memalign(&p, alignment, size) != 0){
+				p = nullptr;
+			}
+			if(p){
+				++thread_counts.allocations;
+				thread_counts.bytes_allocated += size;
+			}
+			return p;
+		}
+
+		inline void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+			void* p = allocate(size, alignment);
+			if(!p){
+				throw std::bad_alloc();
+			}
+			return p;
+		}
+
+		inline void deallocate(void* p) noexcept {
+			if(p){
+				++thread_counts.deallocations;
+				std::free(p);
+			}
+		}
+	}
+
+	// Returns the counts for the calling thread since it started.
+	inline alloc_counts thread_alloc_counts() noexcept {
+		return detail::thread_counts;
+	}
+
+	// Measures the allocations made by the calling thread during the
+	// lifetime of the scope object.
+	class alloc_scope {
+		public:
+			alloc_scope() noexcept : start_(detail::thread_counts) {}
+			alloc_scope(const alloc_scope&) = delete;
+			alloc_scope& operator=(const alloc_scope&) = delete;
+
+			// Returns the counts since construction (or the last reset).
+			alloc_counts counts() const noexcept {
+				alloc_counts now = detail::thread_counts;
+				return alloc_counts{now.allocations - start_.allocations,
+				  now.deallocations - start_.deallocations,
+				  now.bytes_allocated - start_.bytes_allocated};
+			}
+
+			// Returns the number of allocations since construction.
+			std::uint64_t allocations() const noexcept { return counts().allocations; }
+
+			// Restarts counting from zero.
+			void reset() noexcept { start_ = detail::thread_counts; }
+
+		private:
+			alloc_counts start_;
+	};
+
+}
+
+void* operator new(std::size_t size) {
+	return ra::harness::detail::allocate_or_throw(size, 0);
+}
+void* operator new[](std::size_t size) {
+	return ra::harness::detail::allocate_or_throw(size, 0);
+}
+void* operator new(std::size_t size, std::align_val_t al) {
+	return ra::harness::detail::allocate_or_throw(size, std::size_t(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+	return ra::harness::detail::allocate_or_throw(size, std::size_t(al));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return ra::harness::detail::allocate(size, 0);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return ra::harness::detail::allocate(size, 0);
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+	return ra::harness::detail::allocate(size, std::size_t(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+	return ra::harness::detail::allocate(size, std::size_t(al));
+}
+void operator delete(void* p) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete[](void* p) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { ra::harness::detail::deallocate(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { ra::harness::detail::deallocate(p); }
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef ra_harness_check_hpp
+#define ra_harness_check_hpp
+
+/*
+
+Assertions for test programs.
+
+RA_CHECK(cond) reports a failed condition (with its source location) on
+standard error and records the failure; unlike assert, it is not
+disabled by NDEBUG. A test program returns ra::harness::exit_status()
+from main, which is nonzero if any check failed.
+
+RA_CHECK_ALLOCS(n, stmt) executes stmt and checks that it performed
+exactly n allocations on the calling thread (which requires
+alloc_tracker.hpp to be included in the program).
+
+*/
+
+#include<cstdlib>
+#include<iostream>
+
+namespace ra::harness {
+
+	namespace detail {
+		inline int failures = 0;
+	}
+
+	inline void check(bool ok, const char* expr, const char* file, int line) {
+		if(!ok){
+			++detail::failures;
+			std::cerr<<file<<":"<<line<<": check failed: "<<expr<<std::endl;
+		}
+	}
+
+	inline int exit_status() {
+		return detail::failures ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+}
+
+#define RA_CHECK(cond) ::ra::harness::check(static_cast<bool>(cond), #cond, __FILE__, __LINE__)
+
+#define RA_CHECK_ALLOCS(n, stmt) \
+	do { \
+		::ra::harness::alloc_scope ra_check_scope_; \
+		stmt; \
+		::ra::harness::check(ra_check_scope_.allocations() == (n), \
+		  "allocations in `" #stmt "` == " #n, __FILE__, __LINE__); \
+	} while(0)
+
+#endif
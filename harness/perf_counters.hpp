@@ -0,0 +1,117 @@
+#ifndef ra_harness_perf_counters_hpp
+#define ra_harness_perf_counters_hpp
+
+/*
+
+Hardware performance counters for test and benchmark programs.
+
+On Linux, perf_counters opens (via perf_event_open) a group of counters
+for the calling thread: instructions, cache misses and branch misses.
+Counting is done only between calls to start() and stop(). Where the
+counters cannot be opened (other platforms, or when the kernel does not
+permit it, e.g., because of perf_event_paranoid or in a container),
+available() is false and all readings are zero, so callers need not
+treat this case specially.
+
+*/
+
+#include<cstdint>
+
+#if defined(__linux__)
+#include<cstring>
+#include<linux/perf_event.h>
+#include<sys/ioctl.h>
+#include<sys/syscall.h>
+#include<unistd.h>
+#endif
+
+namespace ra::harness {
+
+	// Counter readings.
+	struct perf_readings {
+		std::uint64_t instructions = 0;
+		std::uint64_t cache_misses = 0;
+		std::uint64_t branch_misses = 0;
+	};
+
+	class perf_counters {
+		public:
+			perf_counters() noexcept : fds_{-1, -1, -1} {
+#if defined(__linux__)
+				const std::uint64_t configs[count] = {
+					PERF_COUNT_HW_INSTRUCTIONS,
+					PERF_COUNT_HW_CACHE_MISSES,
+					PERF_COUNT_HW_BRANCH_MISSES
+				};
+				for(int i=0; i<count; ++i){
+					perf_event_attr attr;
+					std::memset(&attr, 0, sizeof(attr));
+					attr.type = PERF_TYPE_HARDWARE;
+					attr.size = sizeof(attr);
+					attr.config = configs[i];
+					attr.disabled = (i == 0);
+					attr.exclude_kernel = 1;
+					attr.exclude_hv = 1;
+					attr.read_format = PERF_FORMAT_GROUP;
+					fds_[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, fds_[0], 0));
+					if(fds_[i] < 0){
+						close_all();
+						return;
+					}
+				}
+#endif
+			}
+			perf_counters(const perf_counters&) = delete;
+			perf_counters& operator=(const perf_counters&) = delete;
+			~perf_counters() { close_all(); }
+
+			// Returns true if the counters could be opened.
+			bool available() const noexcept { return fds_[0] >= 0; }
+
+			// Resets the counters to zero and starts counting.
+			void start() noexcept {
+#if defined(__linux__)
+				if(available()){
+					::ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+					::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+				}
+#endif
+			}
+
+			// Stops counting and returns the counts since start().
+			perf_readings stop() noexcept {
+				perf_readings result;
+#if defined(__linux__)
+				if(available()){
+					::ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+					std::uint64_t values[1 + count];
+					if(::read(fds_[0], values, sizeof(values)) == sizeof(values)){
+						result.instructions = values[1];
+						result.cache_misses = values[2];
+						result.branch_misses = values[3];
+					}
+				}
+#endif
+				return result;
+			}
+
+		private:
+			static constexpr int count = 3;
+
+			void close_all() noexcept {
+				for(int& fd : fds_){
+#if defined(__linux__)
+					if(fd >= 0){
+						::close(fd);
+					}
+#endif
+					fd = -1;
+				}
+			}
+
+			int fds_[count];
+	};
+
+}
+
+#endif
@@ -0,0 +1,397 @@
+#ifndef ADAPTIVEINTSETHPP
+#define ADAPTIVEINTSETHPP
+
+#include<stddef.h>
+#include<algorithm>
+#include<cstdint>
+#include<functional>
+#include<iterator>
+#include<type_traits>
+#include<utility>
+#include<vector>
+#include"sv_set.hpp"
+
+namespace ra::container {
+
+	// A class representing a set of unique integers that adapts its
+	// representation to the density of its elements.
+	// The set starts as a sorted array (an sv_set). When the elements are
+	// non-negative and the sorted array would need at least as much
+	// memory as a bitmap covering [0, largest element], the set switches
+	// to the bitmap, which gives constant-time membership tests. When
+	// elements are erased from a bitmap until the sorted array would
+	// need less than a quarter of the memory of the bitmap, the set
+	// switches back. (The gap between the two thresholds avoids
+	// switching back and forth when the size hovers around one of them.)
+	// Iteration is always in ascending order.
+	// The interface is that of sv_set<Key> (plus contains and
+	// lower_bound), except that: the order is always std::less<Key>, and
+	// no statistics are collected; the iterators are non-mutable and
+	// bidirectional (not random-access), and dereference to the element
+	// by value, since a bitmap does not store its elements; and reserve
+	// and capacity apply only to the sorted array (see below).
+	template <class Key>
+	class adaptive_int_set {
+		static_assert(std::is_integral_v<Key> && !std::is_same_v<Key, bool>,
+		  "the key type of an adaptive_int_set must be an integer type");
+		public:
+			// The type of the elements held by the container.
+			using value_type = Key;
+			using key_type = Key;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// The type of the comparison object (the elements are always
+			// in ascending order).
+			using key_compare = std::less<Key>;
+
+			// The type of the sorted array used for sparse sets.
+			using sparse_type = sv_set<Key>;
+
+			// The tag type for the range constructor (see sv_set).
+			using ordered_and_unique_range = typename sparse_type::ordered_and_unique_range;
+
+			// The non-mutable (bidirectional) iterator type for the
+			// container. Since a bitmap does not store its elements,
+			// dereferencing an iterator yields the element by value.
+			class const_iterator {
+				public:
+					using value_type = Key;
+					using iterator_category = std::bidirectional_iterator_tag;
+					using difference_type = std::ptrdiff_t;
+					using pointer = const Key*;
+					using reference = Key;
+					const_iterator() : set_(nullptr), pos_(0) {}
+					Key operator*() const {
+						return set_->dense_ ? Key(pos_) : *(set_->sparse_.begin() + pos_);
+					}
+					const_iterator& operator++() {
+						pos_ = set_->dense_ ? set_->next_bit(pos_ + 1) : pos_ + 1;
+						return *this;
+					}
+					const_iterator operator++(int) {
+						const_iterator old(*this);
+						++(*this);
+						return old;
+					}
+					const_iterator& operator--() {
+						pos_ = set_->dense_ ? set_->prev_bit(pos_ - 1) : pos_ - 1;
+						return *this;
+					}
+					const_iterator operator--(int) {
+						const_iterator old(*this);
+						--(*this);
+						return old;
+					}
+					bool operator==(const const_iterator& other) const { return pos_ == other.pos_; }
+					bool operator!=(const const_iterator& other) const { return pos_ != other.pos_; }
+				private:
+					friend class adaptive_int_set;
+					const_iterator(const adaptive_int_set* set, size_type pos) : set_(set), pos_(pos) {}
+					// The container and the position in it: the index into the
+					// sorted array, or the bit index (i.e., the element) in the
+					// bitmap.
+					const adaptive_int_set* set_;
+					size_type pos_;
+			};
+			using iterator = const_iterator;
+
+			// Creates an empty set.
+			// Time complexity: Constant.
+			adaptive_int_set() : dense_(false), count_(0) {}
+
+			// Creates a set consisting of the n elements in the range
+			// starting at first (see the corresponding sv_set constructor).
+			// Time complexity: As for n insertions.
+			template <class InputIterator>
+			adaptive_int_set(ordered_and_unique_range, InputIterator first, size_type n) : adaptive_int_set() {
+				for(size_type i=0; i<n; ++i){
+					insert(*first);
+					++first;
+				}
+			}
+
+			// Move and copy construction and assignment.
+			// A moved-from set is empty.
+			adaptive_int_set(adaptive_int_set&& other) noexcept
+			  : sparse_(std::move(other.sparse_)), bits_(std::move(other.bits_)), dense_(other.dense_), count_(other.count_) {
+				other.bits_.clear();
+				other.dense_ = false;
+				other.count_ = 0;
+			}
+			adaptive_int_set& operator=(adaptive_int_set&& other) noexcept {
+				if(this != &other){
+					sparse_ = std::move(other.sparse_);
+					bits_ = std::move(other.bits_);
+					dense_ = other.dense_;
+					count_ = other.count_;
+					other.bits_.clear();
+					other.dense_ = false;
+					other.count_ = 0;
+				}
+				return *this;
+			}
+			adaptive_int_set(const adaptive_int_set&) = default;
+			adaptive_int_set& operator=(const adaptive_int_set&) = default;
+			~adaptive_int_set() = default;
+
+			// Returns true if the set currently uses the bitmap.
+			// Time complexity: Constant.
+			bool is_dense() const noexcept { return dense_; }
+
+			// Returns the comparison object for the container.
+			// Time complexity: Constant.
+			key_compare key_comp() const { return key_compare(); }
+
+			// Returns an iterator referring to the first (i.e., smallest)
+			// element in the set if the set is not empty and end() otherwise.
+			// Time complexity: Constant for a sparse set; linear in the
+			// size of the bitmap for a dense set.
+			const_iterator begin() const noexcept {
+				return const_iterator(this, dense_ ? next_bit(0) : 0);
+			}
+
+			// Returns an iterator referring to the fictitious
+			// one-past-the-end element for the set.
+			// Time complexity: Constant.
+			const_iterator end() const noexcept {
+				return const_iterator(this, dense_ ? universe() : sparse_.size());
+			}
+
+			// Returns the number of elements in the set.
+			// Time complexity: Constant.
+			size_type size() const noexcept { return dense_ ? count_ : sparse_.size(); }
+
+			// Returns the number of elements for which storage is available:
+			// the capacity of the sorted array for a sparse set, and the
+			// number of bits allocated for the bitmap (i.e., one more than
+			// the largest element that can be inserted without allocation)
+			// for a dense set.
+			// Time complexity: Constant.
+			size_type capacity() const noexcept {
+				return dense_ ? bits_.capacity() * 64 : sparse_.capacity();
+			}
+
+			// Reserves storage in the sorted array of a sparse set for at
+			// least n elements (see sv_set::reserve). Unlike for sv_set,
+			// inserting may still allocate if the set switches to a bitmap.
+			// For a dense set, whose storage depends on its largest element
+			// rather than its size, this function has no effect.
+			// Time complexity: At most linear in size().
+			void reserve(size_type n) {
+				if(!dense_){
+					sparse_.reserve(n);
+				}
+			}
+
+			// Reduces the storage of the container to that needed for its
+			// elements.
+			// Time complexity: At most linear in size() (or the size of the
+			// bitmap).
+			void shrink_to_fit() {
+				sparse_.shrink_to_fit();
+				bits_.shrink_to_fit();
+			}
+
+			// Inserts the element x in the set.
+			// If the element x is already in the set, no insertion is
+			// performed.
+			// Return value: The second component of the returned pair is
+			// true if and only if the insertion takes place; and the first
+			// component refers to the element equal to x.
+			// Time complexity: Amortized constant for a dense set (if x is
+			// within the bitmap); as for sv_set for a sparse set; plus
+			// linear in size() if the representation changes.
+			std::pair<const_iterator, bool> insert(const key_type& x) {
+				if(dense_){
+					if(x < 0){
+						make_sparse();
+					}
+					else if(size_type(x) >= universe()){
+						if((count_ + 1) * sizeof(key_type) >= bitmap_bytes(size_type(x))){
+							bits_.resize(size_type(x) / 64 + 1, 0);
+						}
+						else{
+							make_sparse();
+						}
+					}
+				}
+				if(dense_){
+					std::uint64_t& word = bits_[size_type(x) / 64];
+					std::uint64_t mask = std::uint64_t(1) << (size_type(x) % 64);
+					bool inserted = !(word & mask);
+					word |= mask;
+					count_ += inserted;
+					return std::pair<const_iterator, bool>(const_iterator(this, size_type(x)), inserted);
+				}
+				std::pair<typename sparse_type::iterator, bool> res = sparse_.insert(x);
+				if(res.second && should_be_dense()){
+					make_dense();
+					return std::pair<const_iterator, bool>(const_iterator(this, size_type(x)), true);
+				}
+				return std::pair<const_iterator, bool>(const_iterator(this, res.first - sparse_.begin()), res.second);
+			}
+
+			// Erases the element referenced by pos from the container.
+			// Returns an iterator referring to the element following the
+			// erased one if such an element exists or end() otherwise.
+			// Time complexity: Constant for a dense set (unless the
+			// representation changes); as for sv_set for a sparse set.
+			const_iterator erase(const_iterator pos) {
+				if(!dense_){
+					typename sparse_type::iterator next = sparse_.erase(sparse_.begin() + pos.pos_);
+					return const_iterator(this, next - sparse_.begin());
+				}
+				key_type x = key_type(pos.pos_);
+				bits_[pos.pos_ / 64] &= ~(std::uint64_t(1) << (pos.pos_ % 64));
+				--count_;
+				while(!bits_.empty() && bits_.back() == 0){
+					bits_.pop_back();
+				}
+				if(count_ == 0 || 4 * count_ * sizeof(key_type) < bits_.size() * sizeof(std::uint64_t)){
+					make_sparse();
+					return lower_bound(x);
+				}
+				return const_iterator(this, next_bit(pos.pos_));
+			}
+
+			// Swaps the contents of the container with the contents of the
+			// container x.
+			// Time complexity: Constant.
+			void swap(adaptive_int_set& x) noexcept {
+				sparse_.swap(x.sparse_);
+				bits_.swap(x.bits_);
+				std::swap(dense_, x.dense_);
+				std::swap(count_, x.count_);
+			}
+
+			// Erases any elements in the container, yielding an empty
+			// (sparse) container.
+			// Time complexity: Linear in size().
+			void clear() noexcept {
+				sparse_.clear();
+				bits_.clear();
+				dense_ = false;
+				count_ = 0;
+			}
+
+			// Searches the container for an element with the key k.
+			// If an element is found, an iterator referencing the element
+			// is returned; otherwise, end() is returned.
+			// Time complexity: Constant for a dense set; logarithmic for a
+			// sparse set.
+			const_iterator find(const key_type& k) const {
+				if(dense_){
+					return contains(k) ? const_iterator(this, size_type(k)) : end();
+				}
+				typename sparse_type::const_iterator i = sparse_.find(k);
+				return const_iterator(this, i - sparse_.begin());
+			}
+
+			// Returns true if the set contains an element with the key k.
+			// Time complexity: Constant for a dense set; logarithmic for a
+			// sparse set.
+			bool contains(const key_type& k) const {
+				if(dense_){
+					return k >= 0 && size_type(k) < universe() &&
+					  ((bits_[size_type(k) / 64] >> (size_type(k) % 64)) & 1);
+				}
+				return sparse_.find(k) != sparse_.end();
+			}
+
+			// Returns an iterator referring to the first element not less
+			// than k, or end() if there is none.
+			// Time complexity: Linear in the size of the bitmap for a dense
+			// set; logarithmic for a sparse set.
+			const_iterator lower_bound(const key_type& k) const {
+				if(dense_){
+					return const_iterator(this, k < 0 ? next_bit(0) : next_bit(size_type(k)));
+				}
+				typename sparse_type::const_iterator i = std::lower_bound(sparse_.begin(), sparse_.end(), k);
+				return const_iterator(this, i - sparse_.begin());
+			}
+
+		private:
+
+			// The number of bits in the bitmap.
+			size_type universe() const noexcept { return bits_.size() * 64; }
+
+			// The size in bytes of a bitmap that can hold the element x.
+			static size_type bitmap_bytes(size_type x) noexcept {
+				return (x / 64 + 1) * sizeof(std::uint64_t);
+			}
+
+			// Returns the smallest element not less than i in the bitmap, or
+			// universe() if there is none.
+			size_type next_bit(size_type i) const noexcept {
+				size_type w = i / 64;
+				if(w >= bits_.size()){
+					return universe();
+				}
+				std::uint64_t word = bits_[w] & (~std::uint64_t(0) << (i % 64));
+				while(word == 0){
+					if(++w == bits_.size()){
+						return universe();
+					}
+					word = bits_[w];
+				}
+				return w * 64 + size_type(__builtin_ctzll(word));
+			}
+
+			// Returns the largest element not greater than i in the bitmap.
+			// Precondition: There is such an element.
+			size_type prev_bit(size_type i) const noexcept {
+				size_type w = i / 64;
+				std::uint64_t word = bits_[w] & (~std::uint64_t(0) >> (63 - i % 64));
+				while(word == 0){
+					word = bits_[--w];
+				}
+				return w * 64 + 63 - size_type(__builtin_clzll(word));
+			}
+
+			// Returns true if a (sparse) set should switch to a bitmap.
+			bool should_be_dense() const noexcept {
+				const key_type* first = sparse_.begin();
+				if(sparse_.size() == 0 || *first < 0){
+					return false;
+				}
+				key_type largest = *(first + (sparse_.size() - 1));
+				return sparse_.size() * sizeof(key_type) >= bitmap_bytes(size_type(largest));
+			}
+
+			// Converts the sorted array into a bitmap.
+			void make_dense() {
+				const key_type* first = sparse_.begin();
+				key_type largest = *(first + (sparse_.size() - 1));
+				bits_.assign(size_type(largest) / 64 + 1, 0);
+				for(size_type i=0; i<sparse_.size(); ++i){
+					size_type x = size_type(*(first + i));
+					bits_[x / 64] |= std::uint64_t(1) << (x % 64);
+				}
+				count_ = sparse_.size();
+				dense_ = true;
+				sparse_type().swap(sparse_);
+			}
+
+			// Converts the bitmap into a sorted array.
+			void make_sparse() {
+				sparse_type s;
+				s.reserve(count_);
+				for(size_type i=next_bit(0); i<universe(); i=next_bit(i+1)){
+					s.insert(key_type(i));
+				}
+				sparse_.swap(s);
+				std::vector<std::uint64_t>().swap(bits_);
+				dense_ = false;
+				count_ = 0;
+			}
+
+			sparse_type sparse_;
+			std::vector<std::uint64_t> bits_;
+			bool dense_;
+			size_type count_;
+	};
+
+}
+#endif
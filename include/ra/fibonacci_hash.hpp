@@ -0,0 +1,39 @@
+#ifndef ra_util_fibonacci_hash_hpp
+#define ra_util_fibonacci_hash_hpp
+#include<cstddef>
+#include<cstdint>
+
+/*
+
+Bucket selection for the hashed containers in this project.
+
+A hash value is mapped to one of a power-of-two number of buckets by
+taking the high bits of its product with 2^64 divided by the golden ratio
+(Fibonacci hashing). Unlike taking the low bits, this spreads the keys
+over all of the buckets even for hash functions that leave low bits
+unused (like the identity function that std::hash uses for integers).
+
+*/
+
+namespace ra::util {
+
+	// Returns the shift that fibonacci_bucket uses to choose among
+	// bucket_count buckets.
+	// Precondition: bucket_count is a power of two (at least two).
+	inline unsigned fibonacci_shift(std::size_t bucket_count) noexcept {
+		unsigned shift = 64;
+		for(std::size_t n = bucket_count; n > 1; n /= 2){
+			--shift;
+		}
+		return shift;
+	}
+
+	// Returns the index of the bucket for the hash value hash, among the
+	// buckets for which fibonacci_shift returned shift.
+	inline std::size_t fibonacci_bucket(std::size_t hash, unsigned shift) noexcept {
+		return std::size_t((std::uint64_t(hash) * 0x9e3779b97f4a7c15u) >> shift);
+	}
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef FROZENSVSETHPP
+#define FROZENSVSETHPP
+
+#include<stddef.h>
+#include<functional>
+#include<utility>
+
+namespace ra::container {
+
+	// A class representing an immutable set of unique elements (which
+	// uses a sorted array of fixed capacity N).
+	// Unlike sv_set, the set is built and searched entirely in constant
+	// expressions, so a set declared constexpr is sorted at compile time
+	// and placed in read-only storage, and uses no heap memory.
+	// The type Key must be a literal type, and the comparison operation
+	// embodied by Compare must be usable in constant expressions.
+	template <class Key, std::size_t N, class Compare = std::less<Key>>
+	class frozen_sv_set {
+		static_assert(N > 0, "a frozen_sv_set must have a nonzero capacity");
+		public:
+			// The type of the elements held by the container.
+			using value_type = Key;
+			using key_type = Key;
+
+			// The type of the function/functor used to compare two keys.
+			using key_compare = Compare;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// The (non-mutable, random-access) iterator types for the
+			// container. The elements of the set can never be modified.
+			using const_iterator = const Key*;
+			using iterator = const_iterator;
+
+			// The largest capacity for which lookups use a fully unrolled
+			// branchless binary search. Larger sets use a loop with
+			// branches, which lets the processor speculatively fetch the
+			// next probe (and is better for sets that do not fit in cache).
+			static constexpr size_type unrolled_search_limit = 256;
+
+			// Creates a set consisting of the N elements of the array
+			// keys, which may be in any order and may contain duplicates
+			// (in which case, the size of the set is less than N).
+			// Time complexity: N log N.
+			constexpr frozen_sv_set(const Key (&keys)[N]) : keys_(), size_(0), compare_obj_() {
+				for(size_type i=0; i<N; ++i){
+					keys_[i] = keys[i];
+				}
+				sort();
+				// Remove duplicates.
+				size_ = 1;
+				for(size_type i=1; i<N; ++i){
+					if(compare_obj_(keys_[size_-1], keys_[i])){
+						keys_[size_] = keys_[i];
+						++size_;
+					}
+				}
+				// Fill the unused slots with the largest element, so that
+				// a search over all N slots finds the same position as a
+				// search over the elements of the set.
+				for(size_type i=size_; i<N; ++i){
+					keys_[i] = keys_[size_-1];
+				}
+			}
+
+			// Returns the comparison object for the container.
+			// Time complexity: Constant.
+			constexpr key_compare key_comp() const { return compare_obj_; }
+
+			// Returns an iterator referring to the first element in the set.
+			// Time complexity: Constant.
+			constexpr const_iterator begin() const noexcept { return keys_; }
+
+			// Returns an iterator referring to the fictitious
+			// one-past-the-end element for the set.
+			// Time complexity: Constant.
+			constexpr const_iterator end() const noexcept { return keys_ + size_; }
+
+			// Returns the number of elements in the set.
+			// Time complexity: Constant.
+			constexpr size_type size() const noexcept { return size_; }
+
+			// Returns the capacity of the set (i.e., N).
+			// Time complexity: Constant.
+			static constexpr size_type capacity() noexcept { return N; }
+
+			// Returns an iterator referring to the first element that is
+			// not less than k, or end() if there is no such element.
+			// Time complexity: Logarithmic.
+			constexpr const_iterator lower_bound(const key_type& k) const {
+				const_iterator pos = keys_;
+				if constexpr(N <= unrolled_search_limit){
+					pos = unrolled_lower_bound<N>(keys_, k);
+				}
+				else{
+					size_type n = N;
+					while(n > 0){
+						size_type half = n / 2;
+						if(compare_obj_(pos[half], k)){
+							pos += half + 1;
+							n -= half + 1;
+						}
+						else{
+							n = half;
+						}
+					}
+				}
+				return pos < end() ? pos : end();
+			}
+
+			// Searches the container for an element with the key k.
+			// If an element is found, an iterator referencing the element
+			// is returned; otherwise, end() is returned.
+			// Time complexity: Logarithmic.
+			constexpr const_iterator find(const key_type& k) const {
+				const_iterator pos = lower_bound(k);
+				return (pos != end() && !compare_obj_(k, *pos)) ? pos : end();
+			}
+
+			// Returns true if the set contains an element with the key k.
+			// Time complexity: Logarithmic.
+			constexpr bool contains(const key_type& k) const {
+				return find(k) != end();
+			}
+
+		private:
+			// Binary search over Len elements starting at first, unrolled
+			// at compile time into log2(Len) conditional moves.
+			template <size_type Len>
+			constexpr const_iterator unrolled_lower_bound(const_iterator first, const key_type& k) const {
+				if constexpr(Len == 1){
+					return first + (compare_obj_(*first, k) ? 1 : 0);
+				}
+				else{
+					constexpr size_type half = Len / 2;
+					return unrolled_lower_bound<Len - half>(compare_obj_(first[half], k) ? first + half : first, k);
+				}
+			}
+
+			// Sorts keys_ (heapsort, which needs no extra storage and is
+			// usable in a constant expression).
+			constexpr void sort() {
+				for(size_type i=N/2; i>0; --i){
+					sift_down(i-1, N);
+				}
+				for(size_type n=N-1; n>0; --n){
+					swap_keys(0, n);
+					sift_down(0, n);
+				}
+			}
+			constexpr void sift_down(size_type i, size_type n) {
+				for(;;){
+					size_type child = 2*i + 1;
+					if(child >= n){
+						return;
+					}
+					if(child + 1 < n && compare_obj_(keys_[child], keys_[child+1])){
+						++child;
+					}
+					if(!compare_obj_(keys_[i], keys_[child])){
+						return;
+					}
+					swap_keys(i, child);
+					i = child;
+				}
+			}
+			constexpr void swap_keys(size_type i, size_type j) {
+				Key temp = keys_[i];
+				keys_[i] = keys_[j];
+				keys_[j] = temp;
+			}
+
+			Key keys_[N];
+			size_type size_;
+			key_compare compare_obj_;
+	};
+
+	// Deduce the key type and capacity from an array of keys.
+	template <class Key, std::size_t N>
+	frozen_sv_set(const Key (&)[N]) -> frozen_sv_set<Key, N>;
+
+}
+#endif
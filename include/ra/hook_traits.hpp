@@ -0,0 +1,45 @@
+#ifndef HOOKTRAITSHPP
+#define HOOKTRAITSHPP
+
+#include"parent_from_member.hpp"
+#include<type_traits>
+#include<utility>
+
+namespace ra::intrusive {
+
+	// Passing base_hook as the Hook argument of an intrusive container
+	// selects a base hook: T is (publicly) derived from the hook class, and
+	// an element and its hook are converted to each other with a
+	// static_cast.
+	enum class base_hook_t { value };
+	inline constexpr base_hook_t base_hook = base_hook_t::value;
+
+	// The hook type of a container of T with the Hook argument Hook, and
+	// the conversions between elements and their hooks, shared by all of
+	// the intrusive containers. Hook is either a pointer to the hook data
+	// member of T, or base_hook, in which case the hook type is BaseHook
+	// (a base class of T). For a member hook, the conversion from a hook
+	// to its element subtracts the (constant) offset of the hook in T.
+	template <class T, auto Hook, class BaseHook>
+	struct hook_traits {
+		using hook_type = std::remove_reference_t<decltype(std::declval<T&>().*Hook)>;
+		static hook_type* to_hook(T* x) noexcept { return &(x->*Hook); }
+		static const hook_type* to_hook(const T* x) noexcept { return &(x->*Hook); }
+		static T* to_value(hook_type* h) noexcept {
+			return ra::util::parent_from_member<T, hook_type>(h, Hook);
+		}
+		static const T* to_value(const hook_type* h) noexcept {
+			return ra::util::parent_from_member<T, hook_type>(h, Hook);
+		}
+	};
+	template <class T, class BaseHook>
+	struct hook_traits<T, base_hook, BaseHook> {
+		using hook_type = BaseHook;
+		static hook_type* to_hook(T* x) noexcept { return x; }
+		static const hook_type* to_hook(const T* x) noexcept { return x; }
+		static T* to_value(hook_type* h) noexcept { return static_cast<T*>(h); }
+		static const T* to_value(const hook_type* h) noexcept { return static_cast<const T*>(h); }
+	};
+
+}
+#endif
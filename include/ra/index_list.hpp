@@ -0,0 +1,293 @@
+#ifndef INDEXLISTHPP
+#define INDEXLISTHPP
+
+#include"hook_traits.hpp"
+#include<cstddef>
+#include<cstdint>
+#include<iterator>
+#include<type_traits>
+
+namespace ra::intrusive {
+
+	// Per-node management information for an index_list: the positions
+	// (in the arena) of the next and previous elements, as 32-bit indices,
+	// so that a hook takes half the space of a list_hook. Since the hooks
+	// hold no pointers, copying an arena (e.g., bitwise, or by mapping it
+	// at another address) copies the lists in it.
+	class index_hook {
+		public:
+			// The index that ends a list (i.e., refers to its head).
+			static constexpr std::uint32_t npos = 0xffffffffu;
+
+			index_hook() noexcept : next_(unlinked), prev_(unlinked) {}
+
+			// Returns true if the node is in a list.
+			// Time complexity: Constant.
+			bool is_linked() const noexcept { return next_ != unlinked; }
+
+			template <class T, auto Hook>
+			friend class index_list;
+		private:
+			// The value of both indices in a hook that is not in a list.
+			static constexpr std::uint32_t unlinked = 0xfffffffeu;
+
+			std::uint32_t next_;
+			std::uint32_t prev_;
+	};
+
+	// The position-independent state of an index_list: the indices of its
+	// first and last elements, and its size. It holds no pointers, so it
+	// can be placed (with the arena) in shared memory or in a mapped file.
+	struct index_list_head {
+		std::uint32_t first = index_hook::npos;
+		std::uint32_t last = index_hook::npos;
+		std::uint32_t size = 0;
+	};
+
+	// Intrusive doubly-linked list of elements in an arena, i.e., an array
+	// of objects of type T (of at most 2^32 - 2 elements), linked by
+	// their positions in the arena. Hook is either a pointer to the
+	// index_hook data member of T, or base_hook if T is derived from
+	// index_hook.
+	// An index_list binds an arena (by its base address) to a list head
+	// (see index_list_head), which are owned by the caller. Only the
+	// index_list itself holds pointers; it can be created wherever the
+	// arena and the head are mapped, e.g., in each process sharing them.
+	template <class T, auto Hook>
+	class index_list {
+		static_assert(std::is_same_v<decltype(Hook), base_hook_t> ||
+		  std::is_same_v<decltype(Hook), index_hook T::*>,
+		  "the hook of an index_list must be a data member of type index_hook, or base_hook");
+		public:
+			// The conversions between elements and their hooks.
+			using hook_traits = ra::intrusive::hook_traits<T, Hook, index_hook>;
+
+			// The type of the elements in the list.
+			using value_type = T;
+
+			// The type of a mutating reference to an element.
+			using reference = T&;
+
+			// The type of a non-mutating reference to an element.
+			using const_reference = const T&;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// The type of the position of an element in the arena.
+			using index_type = std::uint32_t;
+
+		private:
+			// The (bidirectional) iterator classes. An iterator holds the
+			// index of the element it refers to (or npos, for end()), and
+			// the arena and list head needed to resolve indices.
+			template <bool Const>
+			class basic_iterator {
+				public:
+					using value_type = T;
+					using iterator_category = std::bidirectional_iterator_tag;
+					using difference_type = std::ptrdiff_t;
+					using pointer = std::conditional_t<Const, const T*, T*>;
+					using reference = std::conditional_t<Const, const T&, T&>;
+					basic_iterator() noexcept : arena_(nullptr), head_(nullptr), index_(index_hook::npos) {}
+					template <bool C = Const, class = std::enable_if_t<C>>
+					basic_iterator(const basic_iterator<false>& other) noexcept :
+					  arena_(other.arena_), head_(other.head_), index_(other.index_) {}
+					bool operator==(const basic_iterator& other) const noexcept {
+						return index_ == other.index_;
+					}
+					bool operator!=(const basic_iterator& other) const noexcept {
+						return index_ != other.index_;
+					}
+					reference operator*() const noexcept {
+						return arena_[index_];
+					}
+					pointer operator->() const noexcept {
+						return arena_ + index_;
+					}
+					basic_iterator& operator++() noexcept {
+						index_ = hook_of(arena_[index_]).next_;
+						return *this;
+					}
+					basic_iterator operator++(int) noexcept {
+						basic_iterator oldIter(*this);
+						++*this;
+						return oldIter;
+					}
+					basic_iterator& operator--() noexcept {
+						index_ = index_ == index_hook::npos ? head_->last : hook_of(arena_[index_]).prev_;
+						return *this;
+					}
+					basic_iterator operator--(int) noexcept {
+						basic_iterator oldIter(*this);
+						--*this;
+						return oldIter;
+					}
+					// Returns the index of the element referred to.
+					index_type index() const noexcept { return index_; }
+				private:
+					basic_iterator(pointer arena, const index_list_head* head, index_type index) noexcept :
+					  arena_(arena), head_(head), index_(index) {}
+					pointer arena_;
+					const index_list_head* head_;
+					index_type index_;
+					friend class index_list;
+					friend class basic_iterator<!Const>;
+			};
+
+		public:
+			// The mutating (bidirectional) iterator type for the list.
+			using iterator = basic_iterator<false>;
+
+			// The non-mutating (bidirectional) iterator type for the list.
+			using const_iterator = basic_iterator<true>;
+
+			// Binds the arena starting at arena to the list head head.
+			// Time complexity: Constant.
+			index_list(T* arena, index_list_head& head) noexcept : arena_(arena), head_(&head) {}
+
+			// Returns the number of elements in the list.
+			// Time complexity: Constant.
+			size_type size() const noexcept { return head_->size; }
+
+			// Returns true if the list has no elements.
+			// Time complexity: Constant.
+			bool empty() const noexcept { return head_->size == 0; }
+
+			// Returns the position of the element x in the arena.
+			// Time complexity: Constant.
+			index_type index_of(const_reference x) const noexcept { return index_type(&x - arena_); }
+
+			// Returns an iterator referring to the first element in the list
+			// if the list is not empty and end() otherwise.
+			// Time complexity: Constant.
+			iterator begin() noexcept { return iterator(arena_, head_, head_->first); }
+			const_iterator begin() const noexcept { return const_iterator(arena_, head_, head_->first); }
+
+			// Returns an iterator referring to the fictitious one-past-the-end
+			// element.
+			// Time complexity: Constant.
+			iterator end() noexcept { return iterator(arena_, head_, index_hook::npos); }
+			const_iterator end() const noexcept { return const_iterator(arena_, head_, index_hook::npos); }
+
+			// Returns an iterator referring to the element x, which must be
+			// in the list.
+			// Time complexity: Constant.
+			iterator iterator_to(reference x) noexcept { return iterator(arena_, head_, index_of(x)); }
+			const_iterator iterator_to(const_reference x) const noexcept {
+				return const_iterator(arena_, head_, index_of(x));
+			}
+
+			// Returns a reference to the first (or last) element in the list.
+			// Precondition: The list is not empty.
+			// Time complexity: Constant.
+			reference front() noexcept { return arena_[head_->first]; }
+			const_reference front() const noexcept { return arena_[head_->first]; }
+			reference back() noexcept { return arena_[head_->last]; }
+			const_reference back() const noexcept { return arena_[head_->last]; }
+
+			// Inserts the element x (which must be in the arena) before the
+			// element referred to by pos. Returns an iterator referring to
+			// the inserted element.
+			// Precondition: x is not in a list through Hook.
+			// Time complexity: Constant.
+			iterator insert(iterator pos, reference x) noexcept {
+				index_type i = index_of(x);
+				index_hook& h = hook_of(x);
+				index_type next = pos.index_;
+				index_type prev = next == index_hook::npos ? head_->last : hook_of(arena_[next]).prev_;
+				h.next_ = next;
+				h.prev_ = prev;
+				(prev == index_hook::npos ? head_->first : hook_of(arena_[prev]).next_) = i;
+				(next == index_hook::npos ? head_->last : hook_of(arena_[next]).prev_) = i;
+				++head_->size;
+				return iterator(arena_, head_, i);
+			}
+
+			// Inserts the element x at the end (or start) of the list.
+			// Time complexity: Constant.
+			void push_back(reference x) noexcept { insert(end(), x); }
+			void push_front(reference x) noexcept { insert(begin(), x); }
+
+			// Erases the element referred to by pos, resetting its hook.
+			// Returns an iterator referring to the element following it.
+			// Time complexity: Constant.
+			iterator erase(iterator pos) noexcept {
+				index_hook& h = hook_of(arena_[pos.index_]);
+				index_type next = h.next_;
+				index_type prev = h.prev_;
+				(prev == index_hook::npos ? head_->first : hook_of(arena_[prev]).next_) = next;
+				(next == index_hook::npos ? head_->last : hook_of(arena_[next]).prev_) = prev;
+				h.next_ = index_hook::unlinked;
+				h.prev_ = index_hook::unlinked;
+				--head_->size;
+				return iterator(arena_, head_, next);
+			}
+
+			// Erases the element x.
+			// Precondition: x is in the list.
+			// Time complexity: Constant.
+			void erase(reference x) noexcept { erase(iterator_to(x)); }
+
+			// Erases the last (or first) element.
+			// Precondition: The list is not empty.
+			// Time complexity: Constant.
+			void pop_back() noexcept { erase(iterator(arena_, head_, head_->last)); }
+			void pop_front() noexcept { erase(begin()); }
+
+			// Moves all of the elements of other (which must be in the same
+			// arena) into the list before the element referred to by pos,
+			// preserving their relative order. After the splice, other is
+			// empty.
+			// Precondition: The lists *this and other are distinct.
+			// Time complexity: Constant.
+			void splice(iterator pos, index_list& other) noexcept {
+				if(other.empty()){
+					return;
+				}
+				index_type first = other.head_->first;
+				index_type last = other.head_->last;
+				index_type next = pos.index_;
+				index_type prev = next == index_hook::npos ? head_->last : hook_of(arena_[next]).prev_;
+				hook_of(arena_[first]).prev_ = prev;
+				hook_of(arena_[last]).next_ = next;
+				(prev == index_hook::npos ? head_->first : hook_of(arena_[prev]).next_) = first;
+				(next == index_hook::npos ? head_->last : hook_of(arena_[next]).prev_) = last;
+				head_->size += other.head_->size;
+				*other.head_ = index_list_head();
+			}
+
+			// Erases all of the elements, resetting their hooks.
+			// Time complexity: Linear in size().
+			void clear() noexcept {
+				clear_and_dispose([](value_type*) {});
+			}
+
+			// Erases all of the elements and passes each of them (in order,
+			// with its hook already reset) to disposer.
+			// Time complexity: Linear in size() (plus the disposer).
+			template <class Disposer>
+			void clear_and_dispose(Disposer disposer) {
+				index_type i = head_->first;
+				*head_ = index_list_head();
+				while(i != index_hook::npos){
+					T& x = arena_[i];
+					index_hook& h = hook_of(x);
+					i = h.next_;
+					h.next_ = index_hook::unlinked;
+					h.prev_ = index_hook::unlinked;
+					disposer(&x);
+				}
+			}
+
+		private:
+			// Returns the hook of the element x.
+			static index_hook& hook_of(T& x) noexcept { return *hook_traits::to_hook(&x); }
+			static const index_hook& hook_of(const T& x) noexcept { return *hook_traits::to_hook(&x); }
+
+			T* arena_;
+			index_list_head* head_;
+	};
+
+}
+#endif
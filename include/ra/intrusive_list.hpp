@@ -1,11 +1,13 @@
 #ifndef INTRUSIVELISTHPP
 #define INTRUSIVELISTHPP
 
-#include"parent_from_member.hpp"
+#include"hook_traits.hpp"
+#include"stats.hpp"
+#include<cstddef>
 #include<utility>
 #include<iterator>
 #include <type_traits>
-#include<vector>
+#include<functional>
 
 namespace ra::intrusive {
 
@@ -22,14 +24,28 @@ namespace ra::intrusive {
 			// The particular behavior of the following special
 			// member functions are implementation defined and
 			// may be defaulted if appropriate.
-			list_hook() : next_(this), prev_(this) {}
-			list_hook(const list_hook&) = default;
-			list_hook(list_hook&&) = default;
-			list_hook& operator=(const list_hook&) = default;
-			list_hook& operator=(list_hook&&) = default;
+			// Copying a hook never copies its links: a copy starts out
+			// unlinked, and assigning to a hook leaves it unchanged, so
+			// copying an element never makes it appear to be in a list.
+			list_hook() noexcept : next_(this), prev_(this) {}
+			list_hook(const list_hook&) noexcept : next_(this), prev_(this) {}
+			list_hook& operator=(const list_hook&) noexcept { return *this; }
 			~list_hook() = default;
-			template<class T, list_hook T::* Hook>
+
+			// Returns true if the node is in a list.
+			// The hooks of elements removed by erase (or by clear, for
+			// hooks that unlink automatically) are reset, but clear on a
+			// list of plain list_hook members leaves them as they were.
+			// Time complexity: Constant.
+			bool is_linked() const noexcept { return next_ != this; }
+
+			// Whether the hook unlinks itself from its list when it is
+			// destroyed (see auto_unlink_hook).
+			static constexpr bool auto_unlink = false;
+
+			template<class T, auto Hook, class Stats, bool ConstantTimeSize>
 			friend class list;
+			friend class auto_unlink_hook;
 			friend class list_iterator;
 			friend class list_const_iterator;
 		private:
@@ -37,161 +53,172 @@ namespace ra::intrusive {
 			list_hook* prev_;
 	};
 
+	// A list hook that removes its node from the list containing it when
+	// the hook (i.e., the element) is destroyed, or when unlink is called,
+	// without access to the list.
+	// Since elements can leave a list on their own, a list of elements
+	// with this type of hook does not know its size in constant time, and
+	// clearing such a list resets the hooks of its elements.
+	// As for list_hook, copying a hook never copies its links.
+	class auto_unlink_hook : public list_hook {
+		public:
+			auto_unlink_hook() = default;
+			auto_unlink_hook(const auto_unlink_hook&) noexcept : list_hook() {}
+			auto_unlink_hook& operator=(const auto_unlink_hook&) noexcept { return *this; }
+			~auto_unlink_hook() { unlink(); }
+
+			// Removes the node from the list containing it, if any.
+			// Time complexity: Constant.
+			void unlink() noexcept {
+				prev_->next_ = next_;
+				next_->prev_ = prev_;
+				next_ = this;
+				prev_ = this;
+			}
+
+			static constexpr bool auto_unlink = true;
+	};
+
+	// The hook traits (see ra/hook_traits.hpp) of a list of T with the
+	// Hook argument Hook. A base hook is an auto_unlink_hook if T is
+	// derived from one, and a list_hook otherwise.
+	template <class T, auto Hook>
+	using list_hook_traits = hook_traits<T, Hook, std::conditional_t<std::is_base_of_v<auto_unlink_hook, T>,
+	  auto_unlink_hook, list_hook>>;
+
 	// Intrusive doubly-linked list (with sentinel node).
-	template <class T, list_hook T::* Hook>
+	// Hook is either a pointer to the data member of T that holds the list
+	// management information, which must have type list_hook or
+	// auto_unlink_hook (or a class derived from one of them), or base_hook
+	// if T is derived from list_hook or auto_unlink_hook.
+	// The Stats parameter selects whether operation counters are
+	// collected (see ra/stats.hpp); by default, nothing is collected.
+	// The ConstantTimeSize parameter selects whether the list keeps its
+	// size. By default, it does unless its elements may unlink themselves
+	// (which rules it out). A list that does not keep its size consists
+	// of its sentinel hook alone (and is thus smaller, e.g., in arrays of
+	// hash buckets), takes linear time to compute its size, and splices
+	// ranges from other lists in constant time.
+	template <class T, auto Hook, class Stats = ra::util::no_stats,
+	  bool ConstantTimeSize = !list_hook_traits<T, Hook>::hook_type::auto_unlink>
 	class list {
 		public:
-			typedef typename std::vector<T>::const_iterator const_itr_impl;
-			class list_const_iterator : public const_itr_impl {
+			// The conversions between elements and their hooks.
+			using hook_traits = list_hook_traits<T, Hook>;
+
+			// The type of the hook data member (or base class).
+			using hook_type = typename hook_traits::hook_type;
+			static_assert(std::is_base_of_v<list_hook, hook_type>,
+			  "the hook of a list must be a data member of type list_hook or auto_unlink_hook");
+
+			// The non-mutating iterator class. An iterator is a single
+			// pointer to the hook of the element it refers to (or to the
+			// sentinel), and is trivially copyable.
+			class list_const_iterator {
 				public:
-					typedef typename std::iterator_traits<const_itr_impl>::value_type value_type;
-					typedef std::bidirectional_iterator_tag iterator_category;
-					typedef typename std::iterator_traits<const_itr_impl>::difference_type difference_type;
-					typedef typename std::iterator_traits<const_itr_impl>::pointer pointer;
-					typedef typename std::iterator_traits<const_itr_impl>::reference reference;
-					list_const_iterator() : ptr_(nullptr) {}
-					list_const_iterator(const list_hook* ptrval) : ptr_(ptrval) {}
-					list_const_iterator(const T* ptrT) : ptr_(&(ptrT->*hook_ptr)){}
-					~list_const_iterator() = default;
-					list_const_iterator(const list_const_iterator& other) : ptr_(other.ptr_) {}
-					list_const_iterator& operator=(const list_const_iterator& other) {
-						ptr_ = other.ptr_;
-						return *this;
-					}
-					list_const_iterator& operator=(const list_hook* otherPtr) {
-						ptr_ = otherPtr;
-						return *this;
-					}
-					bool operator==(const list_const_iterator& other) const {
-						return (ptr_==(other.ptr_));
-					}
-					bool operator==(const list_hook* otherPtr) const {
-						return (ptr_==otherPtr);
-					}
-					bool operator!=(const list_const_iterator& other) const {
-						return (ptr_!=(other.ptr_));
+					using value_type = T;
+					using iterator_category = std::bidirectional_iterator_tag;
+					using difference_type = std::ptrdiff_t;
+					using pointer = const T*;
+					using reference = const T&;
+					list_const_iterator() noexcept : ptr_(nullptr) {}
+					list_const_iterator(const list_hook* ptrval) noexcept : ptr_(ptrval) {}
+					list_const_iterator(const T* ptrT) noexcept : ptr_(hook_traits::to_hook(ptrT)) {}
+					bool operator==(const list_const_iterator& other) const noexcept {
+						return ptr_ == other.ptr_;
 					}
-					bool operator!=(const list_hook* otherPtr) const {
-						return (ptr_!=otherPtr);
+					bool operator!=(const list_const_iterator& other) const noexcept {
+						return ptr_ != other.ptr_;
 					}
-					const T* operator->() const {
-						const T* el_ptr = ra::util::parent_from_member<value_type,list_hook>(ptr_,hook_ptr);
-						return el_ptr;
+					const T* operator->() const noexcept {
+						return &value_of(ptr_);
 					}
-					const T& operator*() const{
-						const T* el_ptr = ra::util::parent_from_member<value_type,list_hook>(ptr_,hook_ptr);
-						return (*el_ptr);
+					const T& operator*() const noexcept {
+						return value_of(ptr_);
 					}
-
-					list_const_iterator operator++(){
+					list_const_iterator& operator++() noexcept {
 						ptr_ = ptr_->next_;
 						return *this;
 					}
-					list_const_iterator operator++(int){
+					list_const_iterator operator++(int) noexcept {
 						list_const_iterator oldIter(*this);
 						ptr_ = ptr_->next_;
 						return oldIter;
 					}
-					list_const_iterator operator--(){
+					list_const_iterator& operator--() noexcept {
 						ptr_ = ptr_->prev_;
 						return *this;
 					}
-					list_const_iterator operator--(int){
+					list_const_iterator operator--(int) noexcept {
 						list_const_iterator oldIter(*this);
 						ptr_ = ptr_->prev_;
 						return oldIter;
 					}
-					const list_hook* operator&(){ return ptr_; }//return this; }
-					const list_hook* operator()(){ return ptr_; }
-					const list_hook* getPtr() const { return ptr_; }
+					const list_hook* getPtr() const noexcept { return ptr_; }
 				private:
 					const list_hook* ptr_;
 			};
 
-			typedef typename std::vector<T>::iterator itr_impl;
-			class list_iterator : public itr_impl {
+			// The mutating iterator class, which converts to the
+			// non-mutating one.
+			class list_iterator {
 				public:
-					typedef typename std::iterator_traits<itr_impl>::value_type value_type;
-					typedef std::bidirectional_iterator_tag iterator_category;
-					typedef typename std::iterator_traits<itr_impl>::difference_type difference_type;
-					typedef typename std::iterator_traits<itr_impl>::pointer pointer;
-					typedef typename std::iterator_traits<itr_impl>::reference reference;
-					list_iterator() : ptr_(nullptr) {}
-					list_iterator(list_hook* ptrval) : ptr_(ptrval) {}
-					list_iterator(T* ptrT) : ptr_(&(ptrT->*hook_ptr)){}
-					~list_iterator() = default;
-					list_iterator(const list_iterator& other) : ptr_(other.ptr_) {}
-					list_iterator(const list_const_iterator& other): ptr_(other.ptr_) {}
-					list_iterator& operator=(const list_iterator& other) {
-						ptr_ = other.ptr_;
-						return *this;
-					}
-					list_iterator& operator=(const list_const_iterator& other){
-						ptr_ = other.ptr_;
-						return *this;
-					}
-					list_iterator& operator=(list_hook* otherPtr) {
-						ptr_ = otherPtr;
-						return *this;
+					using value_type = T;
+					using iterator_category = std::bidirectional_iterator_tag;
+					using difference_type = std::ptrdiff_t;
+					using pointer = T*;
+					using reference = T&;
+					list_iterator() noexcept : ptr_(nullptr) {}
+					list_iterator(list_hook* ptrval) noexcept : ptr_(ptrval) {}
+					list_iterator(T* ptrT) noexcept : ptr_(hook_traits::to_hook(ptrT)) {}
+					operator list_const_iterator() const noexcept { return list_const_iterator(ptr_); }
+					bool operator==(const list_iterator& other) const noexcept {
+						return ptr_ == other.ptr_;
 					}
-					bool operator==(const list_iterator& other) const {
-						return (ptr_==(other.ptr_));
+					bool operator!=(const list_iterator& other) const noexcept {
+						return ptr_ != other.ptr_;
 					}
-					bool operator==(const list_const_iterator& other) const {
-						return (ptr_==(other.ptr_));
+					bool operator==(const list_const_iterator& other) const noexcept {
+						return ptr_ == other.getPtr();
 					}
-					bool operator==(list_hook* otherPtr) const {
-						return (ptr_==otherPtr);
+					bool operator!=(const list_const_iterator& other) const noexcept {
+						return ptr_ != other.getPtr();
 					}
-					bool operator!=(const list_iterator& other) const {
-						return (ptr_!=(other.ptr_));
+					T* operator->() const noexcept {
+						return &value_of(ptr_);
 					}
-					bool operator!=(const list_const_iterator& other) const {
-						return (ptr_!=(other.ptr_));
+					T& operator*() const noexcept {
+						return value_of(ptr_);
 					}
-					bool operator!=(list_hook* otherPtr) const {
-						return (ptr_!=otherPtr);
-					}
-					T* operator->() const {
-						T* el_ptr = ra::util::parent_from_member<value_type,list_hook>(ptr_,hook_ptr);
-						return el_ptr;
-					}
-					T& operator*() const{
-						T* el_ptr = ra::util::parent_from_member<value_type,list_hook>(ptr_,hook_ptr);
-						return (*el_ptr);
-					}
-
-					list_iterator operator++(){
+					list_iterator& operator++() noexcept {
 						ptr_ = ptr_->next_;
 						return *this;
 					}
-					list_iterator operator++(int){
+					list_iterator operator++(int) noexcept {
 						list_iterator oldIter(*this);
 						ptr_ = ptr_->next_;
 						return oldIter;
 					}
-					list_iterator operator--(){
+					list_iterator& operator--() noexcept {
 						ptr_ = ptr_->prev_;
 						return *this;
 					}
-					list_iterator operator--(int){
+					list_iterator operator--(int) noexcept {
 						list_iterator oldIter(*this);
 						ptr_ = ptr_->prev_;
 						return oldIter;
 					}
-					list_hook* operator&() { return ptr_; }//return this; }
-					list_hook* operator()(){ return ptr_; }
-					list_hook* getPtr() const { return ptr_; }
+					list_hook* getPtr() const noexcept { return ptr_; }
 				private:
 					list_hook* ptr_;
 			};
 
-
 			// The type of the elements in the list.
 			using value_type = T;
 
-			// The pointer-to-member associated with the list hook object.
-			static constexpr list_hook T::* hook_ptr = Hook;
+			// The pointer-to-member associated with the list hook object
+			// (or base_hook).
+			static constexpr auto hook_ptr = Hook;
 
 			// The type of a mutating reference to a node in the list.
 			using reference = T&;
@@ -213,12 +240,32 @@ namespace ra::intrusive {
 			// type.
 			using const_iterator = list_const_iterator;
 
+			// The reverse iterator types for the list.
+			using reverse_iterator = std::reverse_iterator<iterator>;
+			using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
 			// An unsigned integral type used to represent sizes.
 			using size_type = std::size_t;
 
+			// A signed integral type used to represent distances between
+			// iterators.
+			using difference_type = std::ptrdiff_t;
+
+			// The statistics policy and the type of the counters it
+			// collects.
+			using stats_policy = Stats;
+			using stats_type = ra::util::list_stats;
+
+			// Whether size() takes constant time (i.e., the list keeps its
+			// size). This must be false for lists whose elements may unlink
+			// themselves (see auto_unlink_hook).
+			static constexpr bool constant_time_size = ConstantTimeSize;
+			static_assert(!(constant_time_size && hook_type::auto_unlink),
+			  "a list of elements with auto_unlink_hook hooks cannot keep its size");
+
 			// Creates an empty list.
 			// Time complexity: Constant.
-			list() : size_(0) {}
+			list() : size_() {}
 
 			// Erases any elements from the list and then destroys the list.
 			// Time complexity: Either linear or constant.
@@ -232,15 +279,8 @@ namespace ra::intrusive {
 			// their relative order.
 			// After the move, the source list is empty.
 			// Time complexity: Constant.
-			list(list&& other){
-				(other.sent_node_.next_)->prev_ = &sent_node_;
-				(other.sent_node_.prev_)->next_ = &sent_node_;
-				sent_node_.next_ = other.sent_node_.next_;
-				sent_node_.prev_ = other.sent_node_.prev_;
-				size_ = other.size_;
-				other.sent_node_.next_ = &(other.sent_node_);
-				other.sent_node_.prev_ = &(other.sent_node_);
-				other.size_ = size_type(0);
+			list(list&& other) : size_() {
+				splice(end(), other);
 			}
 
 			// Move assignment.
@@ -253,17 +293,10 @@ namespace ra::intrusive {
 			// Precondition: The objects *this and other are distinct.
 			// Time complexity: Constant or linear in size of *this.
 			list& operator=(list&& other){
-				if(size_!=size_type(0)){
+				if(!empty()){
 					clear();
 				}
-				(other.sent_node_.next_)->prev_ = &sent_node_;
-				(other.sent_node_.prev_)->next_ = &sent_node_;
-				sent_node_.next_ = other.sent_node_.next_;
-				sent_node_.prev_ = other.sent_node_.prev_;
-				size_ = other.size_;
-				other.sent_node_.next_ = &(other.sent_node_);
-				other.sent_node_.prev_ = &(other.sent_node_);
-				other.size_ = size_type(0);
+				splice(end(), other);
 				return *this;
 			}
 
@@ -281,34 +314,51 @@ namespace ra::intrusive {
 			}
 
 			// Returns the number of elements in the list.
+			// Time complexity: Constant if constant_time_size is true;
+			// otherwise, linear.
+			size_type size() const {
+				if constexpr(constant_time_size){
+					return size_;
+				}
+				else{
+					size_type n = 0;
+					for(const list_hook* h = sent_node_.next_; h != &sent_node_; h = h->next_){
+						++n;
+					}
+					return n;
+				}
+			}
+
+			// Returns true if the list has no elements.
 			// Time complexity: Constant.
-			size_type size() const { return size_; }
+			bool empty() const { return sent_node_.next_ == &sent_node_; }
+
+			// Returns an iterator referring to the element x, which must be
+			// in a list of this type (not necessarily *this).
+			// Time complexity: Constant.
+			iterator iterator_to(reference x) noexcept { return s_iterator_to(x); }
+			const_iterator iterator_to(const_reference x) const noexcept { return s_iterator_to(x); }
+			static iterator s_iterator_to(reference x) noexcept {
+				return iterator(static_cast<list_hook*>(hook_traits::to_hook(&x)));
+			}
+			static const_iterator s_iterator_to(const_reference x) noexcept {
+				return const_iterator(static_cast<const list_hook*>(hook_traits::to_hook(&x)));
+			}
 
 			// Inserts an element in the list before the element referred to
 			// by the iterator pos.
 			// An iterator that refers to the inserted element is returned.
 			// Time complexity: Constant.
 			iterator insert(iterator pos, value_type& value){
-				if(size_ == size_type(0)){
-					sent_node_.next_ = &(value.*hook_ptr);
-					sent_node_.prev_ = &(value.*hook_ptr);
-					(value.*hook_ptr).next_ = &(sent_node_);
-					(value.*hook_ptr).prev_ = &(sent_node_);
-				}
-				else{
-					list_hook* next_hook = pos.getPtr();
-					list_hook* current_hook = &(value.*hook_ptr);
-					list_hook* prev_hook = next_hook->prev_;
-					prev_hook->next_ = current_hook;
-					current_hook->prev_ = prev_hook;
-					current_hook->next_ = next_hook;
-					next_hook->prev_ = current_hook;	
-				}
-				++size_;
-				list_hook* return_hook = &(value.*hook_ptr);
-				iterator return_ptr = iterator(return_hook);
-				//iterator elmnt_ptr = ra::util::parent_from_member<value_type,list_hook>(current_hook,hook_ptr);
-				return return_ptr;
+				list_hook* next_hook = pos.getPtr();
+				list_hook* current_hook = hook_traits::to_hook(&value);
+				list_hook* prev_hook = next_hook->prev_;
+				prev_hook->next_ = current_hook;
+				current_hook->prev_ = prev_hook;
+				current_hook->next_ = next_hook;
+				next_hook->prev_ = current_hook;
+				grow(1);
+				return iterator(current_hook);
 			}
 
 			// Erases the element in the list at the position specified by the
@@ -318,7 +368,7 @@ namespace ra::intrusive {
 			// returned.
 			// Time complexity: Constant.
 			iterator erase(iterator pos){
-				if(size_ == size_type(0)){
+				if(empty()){
 					return end();
 				}
 				else{
@@ -329,7 +379,7 @@ namespace ra::intrusive {
 					next_hook->prev_ = prev_hook;
 					current_hook->prev_ = current_hook;
 					current_hook->next_ = current_hook;
-					--size_;
+					shrink(1);
 					return (iterator(next_hook));
 				}
 			}
@@ -348,50 +398,430 @@ namespace ra::intrusive {
 				iterator res = erase(last);
 			}
 
+			// Erases the elements in the range [first, last) from the list.
+			// An iterator referring to last is returned.
+			// Time complexity: Linear in the number of elements erased.
+			iterator erase(iterator first, iterator last){
+				list_hook* first_hook = first.getPtr();
+				list_hook* last_hook = last.getPtr();
+				if(first_hook != last_hook){
+					list_hook* prev_hook = first_hook->prev_;
+					prev_hook->next_ = last_hook;
+					last_hook->prev_ = prev_hook;
+					size_type n = 0;
+					while(first_hook != last_hook){
+						list_hook* next_hook = first_hook->next_;
+						first_hook->next_ = first_hook;
+						first_hook->prev_ = first_hook;
+						first_hook = next_hook;
+						++n;
+					}
+					shrink(n);
+				}
+				return last;
+			}
+
+			// Inserts the element with the value x at the start of the list.
+			// Time complexity: Constant.
+			void push_front(value_type& x){
+				insert(iterator(sent_node_.next_),x);
+			}
+
+			// Erases the first element in the list.
+			// Precondition: The list is not empty.
+			// Time complexity: Constant.
+			void pop_front(){
+				erase(iterator(sent_node_.next_));
+			}
+
+			// Returns a reference to the first element in the list.
+			// Precondition: The list is not empty.
+			// Time complexity: Constant.
+			reference front(){
+				return value_of(sent_node_.next_);
+			}
+			const_reference front() const{
+				const list_hook* first_hook = sent_node_.next_;
+				return value_of(first_hook);
+			}
+
+			// Moves all of the elements of other into the list before the
+			// element referred to by pos, preserving their relative order.
+			// After the splice, other is empty.
+			// Precondition: The objects *this and other are distinct.
+			// Time complexity: Constant (unless the list keeps statistics
+			// but not its size).
+			void splice(iterator pos, list& other){
+				if(!other.empty()){
+					size_type n = other.tracked_size();
+					list_hook* first_hook = other.sent_node_.next_;
+					list_hook* last_hook = other.sent_node_.prev_;
+					unlink_range(first_hook, last_hook);
+					link_range(pos.getPtr(), first_hook, last_hook);
+					other.shrink(n);
+					grow(n);
+				}
+			}
+
+			// Moves the element referred to by i from other into the list
+			// before the element referred to by pos.
+			// The lists *this and other may be the same list.
+			// Time complexity: Constant.
+			void splice(iterator pos, list& other, iterator i){
+				list_hook* hook = i.getPtr();
+				if(hook == pos.getPtr() || hook->next_ == pos.getPtr()){
+					return;
+				}
+				unlink_range(hook, hook);
+				link_range(pos.getPtr(), hook, hook);
+				if(&other != this){
+					other.shrink(1);
+					grow(1);
+				}
+			}
+
+			// Moves the elements in the range [first, last) from other into
+			// the list before the element referred to by pos, preserving
+			// their relative order.
+			// The lists *this and other may be the same list, in which case
+			// pos must not be in the range [first, last).
+			// Time complexity: Constant if *this and other are the same list
+			// or the lists do not keep their sizes (or statistics);
+			// otherwise, linear in the number of elements moved (which must
+			// be counted). Use the overload taking n to avoid counting.
+			void splice(iterator pos, list& other, iterator first, iterator last){
+				size_type n = 0;
+				if(&other != this && (constant_time_size || stats_policy::enabled)){
+					for(list_hook* h = first.getPtr(); h != last.getPtr(); h = h->next_){
+						++n;
+					}
+				}
+				splice(pos, other, first, last, n);
+			}
+
+			// Moves the n elements in the range [first, last) from other into
+			// the list before the element referred to by pos, preserving
+			// their relative order.
+			// Precondition: The range [first, last) contains exactly n
+			// elements (if *this and other are different lists), and if
+			// *this and other are the same list, pos is not in the range.
+			// Time complexity: Constant.
+			void splice(iterator pos, list& other, iterator first, iterator last, size_type n){
+				if(first == last){
+					return;
+				}
+				list_hook* first_hook = first.getPtr();
+				list_hook* last_hook = last.getPtr()->prev_;
+				unlink_range(first_hook, last_hook);
+				link_range(pos.getPtr(), first_hook, last_hook);
+				if(&other != this){
+					other.shrink(n);
+					grow(n);
+				}
+			}
+
+			// Merges the sorted list other into the (sorted) list, so that
+			// the list remains sorted with respect to comp. The merge is
+			// stable: equivalent elements from *this precede those from
+			// other. After the merge, other is empty.
+			// Precondition: Both lists are sorted with respect to comp, and
+			// the objects *this and other are distinct.
+			// Time complexity: Linear in size() plus other.size().
+			template <class Compare>
+			void merge(list& other, Compare comp){
+				list_hook* pos = sent_node_.next_;
+				list_hook* other_hook = other.sent_node_.next_;
+				size_type n = other.tracked_size();
+				while(other_hook != &other.sent_node_){
+					if(pos == &sent_node_){
+						// Append the rest of other.
+						list_hook* last_hook = other.sent_node_.prev_;
+						unlink_range(other_hook, last_hook);
+						link_range(pos, other_hook, last_hook);
+						break;
+					}
+					if(comp(value_of(other_hook), value_of(pos))){
+						list_hook* next_hook = other_hook->next_;
+						unlink_range(other_hook, other_hook);
+						link_range(pos, other_hook, other_hook);
+						other_hook = next_hook;
+					}
+					else{
+						pos = pos->next_;
+					}
+				}
+				other.shrink(n);
+				grow(n);
+			}
+			void merge(list& other){
+				merge(other, std::less<value_type>());
+			}
+
+			// Sorts the elements of the list with respect to comp (which is
+			// a less-than predicate), preserving the relative order of
+			// equivalent elements.
+			// The nodes are relinked in place by a bottom-up merge sort; no
+			// memory is allocated and only constant extra space is used.
+			// Time complexity: N log N, where N is size().
+			template <class Compare>
+			void sort(Compare comp){
+				if(sent_node_.next_ == sent_node_.prev_){
+					return;
+				}
+				// Sort the nodes as a null-terminated singly-linked chain
+				// (using only next_), merging runs of width 1, 2, 4, ...
+				list_hook* head = sent_node_.next_;
+				sent_node_.prev_->next_ = nullptr;
+				for(size_type width = 1; ; width *= 2){
+					list_hook* p = head;
+					list_hook* tail = nullptr;
+					head = nullptr;
+					size_type merges = 0;
+					while(p){
+						++merges;
+						list_hook* q = p;
+						size_type p_size = 0;
+						while(p_size < width && q){
+							++p_size;
+							q = q->next_;
+						}
+						size_type q_size = width;
+						while(p_size > 0 || (q_size > 0 && q)){
+							list_hook* e;
+							if(p_size == 0){
+								e = q;
+								q = q->next_;
+								--q_size;
+							}
+							else if(q_size == 0 || !q || !comp(value_of(q), value_of(p))){
+								e = p;
+								p = p->next_;
+								--p_size;
+							}
+							else{
+								e = q;
+								q = q->next_;
+								--q_size;
+							}
+							if(tail){
+								tail->next_ = e;
+							}
+							else{
+								head = e;
+							}
+							tail = e;
+						}
+						p = q;
+					}
+					tail->next_ = nullptr;
+					if(merges <= 1){
+						break;
+					}
+				}
+				// Restore the predecessor links and the sentinel.
+				list_hook* prev_hook = &sent_node_;
+				for(list_hook* h = head; h; h = h->next_){
+					h->prev_ = prev_hook;
+					prev_hook->next_ = h;
+					prev_hook = h;
+				}
+				prev_hook->next_ = &sent_node_;
+				sent_node_.prev_ = prev_hook;
+			}
+			void sort(){
+				sort(std::less<value_type>());
+			}
+
+			// Erases all but the first element from every group of
+			// consecutive elements x, y for which pred(x, y) is true.
+			// Returns the number of elements erased.
+			// Time complexity: Linear in size().
+			template <class BinaryPredicate>
+			size_type unique(BinaryPredicate pred){
+				size_type n = 0;
+				if(!empty()){
+					list_hook* first_hook = sent_node_.next_;
+					list_hook* h = first_hook->next_;
+					while(h != &sent_node_){
+						list_hook* next_hook = h->next_;
+						if(pred(value_of(first_hook), value_of(h))){
+							erase(iterator(h));
+							++n;
+						}
+						else{
+							first_hook = h;
+						}
+						h = next_hook;
+					}
+				}
+				return n;
+			}
+			size_type unique(){
+				return unique(std::equal_to<value_type>());
+			}
+
+			// Erases all elements x for which pred(x) is true.
+			// Returns the number of elements erased.
+			// Time complexity: Linear in size().
+			template <class Predicate>
+			size_type remove_if(Predicate pred){
+				size_type n = 0;
+				list_hook* h = sent_node_.next_;
+				while(h != &sent_node_){
+					list_hook* next_hook = h->next_;
+					if(pred(value_of(h))){
+						erase(iterator(h));
+						++n;
+					}
+					h = next_hook;
+				}
+				return n;
+			}
+
+			// Reverses the order of the elements in the list.
+			// Time complexity: Linear in size().
+			void reverse() noexcept {
+				list_hook* h = &sent_node_;
+				do{
+					list_hook* next_hook = h->next_;
+					h->next_ = h->prev_;
+					h->prev_ = next_hook;
+					h = next_hook;
+				} while(h != &sent_node_);
+			}
+
 			// Returns a reference to the last element in the list.
 			// Precondition: The list is not empty.
 			// Time complexity: Constant.
 			reference back(){
-				list_hook* last_hook = sent_node_.prev_;
-				value_type* last_element = ra::util::parent_from_member<value_type,list_hook>(last_hook,hook_ptr);
-				return (*last_element);
+				return value_of(sent_node_.prev_);
 			}
 			const_reference back() const{
 				const list_hook* last_hook = sent_node_.prev_;
-				const value_type* last_element = ra::util::parent_from_member<value_type,list_hook>(last_hook,hook_ptr);
-				return (*last_element);
+				return value_of(last_hook);
 			}
 
 			// Erases any elements from the list, yielding an empty list.
-			// Time complexity: Either linear or constant.
+			// The hooks of the erased elements are reset only if they are
+			// auto_unlink_hook objects (which must never be left pointing
+			// into a list).
+			// Time complexity: Constant for list_hook; linear for
+			// auto_unlink_hook.
 			void clear(){
-				list_hook* itslf = (sent_node_.prev_)->next_;
-				sent_node_.prev_ = itslf;
-				sent_node_.next_ = itslf;
-				size_ = size_type(0);
+				if constexpr(hook_type::auto_unlink){
+					erase(iterator(sent_node_.next_), end());
+				}
+				else{
+					count_erases(tracked_size());
+					list_hook* itslf = (sent_node_.prev_)->next_;
+					sent_node_.prev_ = itslf;
+					sent_node_.next_ = itslf;
+					if constexpr(constant_time_size){
+						size_ = size_type(0);
+					}
+				}
+			}
+
+			// The following functions erase elements like the corresponding
+			// functions without the _and_dispose suffix, but also call
+			// disposer(p) with a pointer p to each erased element (e.g., to
+			// return it to a pool). The hook of an element is reset before
+			// the element is passed to the disposer, so the disposer may
+			// destroy or reuse the element.
+
+			// Erases the element referred to by pos and disposes of it.
+			// Returns an iterator referring to the element following the
+			// erased element.
+			// Time complexity: Constant (plus the disposer).
+			template <class Disposer>
+			iterator erase_and_dispose(iterator pos, Disposer disposer){
+				list_hook* hook = pos.getPtr();
+				iterator next = erase(pos);
+				disposer(&value_of(hook));
+				return next;
+			}
+
+			// Erases the elements in the range [first, last) and disposes of
+			// them (in order), in a single pass over the range.
+			// An iterator referring to last is returned.
+			// Time complexity: Linear in the number of elements erased.
+			template <class Disposer>
+			iterator erase_and_dispose(iterator first, iterator last, Disposer disposer){
+				list_hook* first_hook = first.getPtr();
+				list_hook* last_hook = last.getPtr();
+				if(first_hook != last_hook){
+					list_hook* prev_hook = first_hook->prev_;
+					prev_hook->next_ = last_hook;
+					last_hook->prev_ = prev_hook;
+					size_type n = 0;
+					while(first_hook != last_hook){
+						list_hook* next_hook = first_hook->next_;
+						first_hook->next_ = first_hook;
+						first_hook->prev_ = first_hook;
+						disposer(&value_of(first_hook));
+						first_hook = next_hook;
+						++n;
+					}
+					shrink(n);
+				}
+				return last;
+			}
+
+			// Erases all of the elements and disposes of them, yielding an
+			// empty list.
+			// Time complexity: Linear in size().
+			template <class Disposer>
+			void clear_and_dispose(Disposer disposer){
+				erase_and_dispose(iterator(sent_node_.next_), end(), disposer);
+			}
+
+			// Erases the last element and disposes of it.
+			// Precondition: The list is not empty.
+			// Time complexity: Constant (plus the disposer).
+			template <class Disposer>
+			void pop_back_and_dispose(Disposer disposer){
+				erase_and_dispose(iterator(sent_node_.prev_), disposer);
+			}
+
+			// Erases the first element and disposes of it.
+			// Precondition: The list is not empty.
+			// Time complexity: Constant (plus the disposer).
+			template <class Disposer>
+			void pop_front_and_dispose(Disposer disposer){
+				erase_and_dispose(iterator(sent_node_.next_), disposer);
+			}
+
+			// Erases all elements x for which pred(x) is true and disposes
+			// of them. Returns the number of elements erased.
+			// Time complexity: Linear in size() (plus the disposer).
+			template <class Predicate, class Disposer>
+			size_type remove_and_dispose_if(Predicate pred, Disposer disposer){
+				size_type n = 0;
+				list_hook* h = sent_node_.next_;
+				while(h != &sent_node_){
+					list_hook* next_hook = h->next_;
+					if(pred(value_of(h))){
+						erase_and_dispose(iterator(h), disposer);
+						++n;
+					}
+					h = next_hook;
+				}
+				return n;
 			}
 
 			// Returns an iterator referring to the first element in the list
 			// if the list is not empty and end() otherwise.
 			// Time complexity: Constant.
 			const_iterator begin() const{
-				if(size_ == size_type(0)){
-					return end();
-				}
-				else{
-					const_iterator first_hook = sent_node_.next_;
-					return first_hook;
-				}
+				count_iteration();
+				const_iterator first_hook = sent_node_.next_;
+				return first_hook;
 			}
 
 			iterator begin(){
-				if(size_ == size_type(0)){
-					return end();
-				}
-				else{
-					iterator first_hook = sent_node_.next_;
-					return first_hook;
-				}
+				count_iteration();
+				iterator first_hook = sent_node_.next_;
+				return first_hook;
 			}
 
 			// Returns an iterator referring to the fictitious one-past-the-end
@@ -404,9 +834,140 @@ namespace ra::intrusive {
 				return &sent_node_;
 			}
 
+			// Returns a reverse iterator referring to the last element in
+			// the list if the list is not empty and rend() otherwise.
+			// Time complexity: Constant.
+			const_reverse_iterator rbegin() const{
+				count_iteration();
+				return const_reverse_iterator(end());
+			}
+			reverse_iterator rbegin(){
+				count_iteration();
+				return reverse_iterator(end());
+			}
+
+			// Returns a reverse iterator referring to the fictitious element
+			// before the first element.
+			// Time complexity: Constant.
+			const_reverse_iterator rend() const{
+				return const_reverse_iterator(const_iterator(sent_node_.next_));
+			}
+			reverse_iterator rend(){
+				return reverse_iterator(iterator(sent_node_.next_));
+			}
+
+			// Returns the operation counters collected so far.
+			// If the statistics policy is disabled, all counters are zero.
+			// Time complexity: Constant.
+			stats_type stats() const noexcept {
+				if constexpr(stats_policy::enabled){
+					return stats_;
+				}
+				else{
+					return stats_type();
+				}
+			}
+
+			// Resets all operation counters to zero.
+			// Time complexity: Constant.
+			void reset_stats() noexcept {
+				if constexpr(stats_policy::enabled){
+					stats_ = stats_type();
+				}
+			}
+
 		private:
+			// Returns the element containing the hook h.
+			static reference value_of(list_hook* h) noexcept {
+				return *hook_traits::to_value(static_cast<hook_type*>(h));
+			}
+			static const_reference value_of(const list_hook* h) noexcept {
+				return *hook_traits::to_value(static_cast<const hook_type*>(h));
+			}
+
+			// Returns the number of elements, if it is needed to maintain
+			// the size or the statistics, and zero otherwise (so that
+			// operations on lists that do not need it remain constant time).
+			size_type tracked_size() const noexcept {
+				if constexpr(constant_time_size){
+					return size_;
+				}
+				else if constexpr(stats_policy::enabled){
+					return size();
+				}
+				else{
+					return 0;
+				}
+			}
+
+			// Record the insertion of n elements into the list.
+			void grow(size_type n) noexcept {
+				if constexpr(constant_time_size){
+					size_ += n;
+				}
+				count_inserts(n);
+			}
+
+			// Record the removal of n elements from the list.
+			void shrink(size_type n) noexcept {
+				if constexpr(constant_time_size){
+					size_ -= n;
+				}
+				count_erases(n);
+			}
+
+			// Links the chain of nodes from first to last (inclusive)
+			// before the node pos.
+			static void link_range(list_hook* pos, list_hook* first, list_hook* last) noexcept {
+				list_hook* prev_hook = pos->prev_;
+				prev_hook->next_ = first;
+				first->prev_ = prev_hook;
+				last->next_ = pos;
+				pos->prev_ = last;
+			}
+
+			// Unlinks the chain of nodes from first to last (inclusive)
+			// from the list containing them. The chain itself is left intact.
+			static void unlink_range(list_hook* first, list_hook* last) noexcept {
+				list_hook* prev_hook = first->prev_;
+				list_hook* next_hook = last->next_;
+				prev_hook->next_ = next_hook;
+				next_hook->prev_ = prev_hook;
+			}
+
+			// Record the insertion of n elements. The high-water size is
+			// only recorded by lists that keep their size.
+			void count_inserts(size_type n) noexcept {
+				if constexpr(stats_policy::enabled){
+					stats_.inserts += n;
+					if constexpr(constant_time_size){
+						if(size_ > stats_.high_water_size){
+							stats_.high_water_size = size_;
+						}
+					}
+				}
+			}
+
+			// Record the erasure of n elements.
+			void count_erases(size_type n) noexcept {
+				if constexpr(stats_policy::enabled){
+					stats_.erases += n;
+				}
+			}
+
+			// Record the start of a traversal.
+			void count_iteration() const noexcept {
+				if constexpr(stats_policy::enabled){
+					++stats_.iterations;
+				}
+			}
+
+			// The type of size_ in lists that do not keep their size.
+			struct no_size {};
+
 			list_hook sent_node_;
-			std::size_t size_;
+			[[no_unique_address]] std::conditional_t<constant_time_size, size_type, no_size> size_;
+			[[no_unique_address]] mutable ra::util::stats_storage_t<stats_policy, stats_type> stats_;
 
 	};
 
@@ -0,0 +1,920 @@
+#ifndef INTRUSIVESETHPP
+#define INTRUSIVESETHPP
+
+#include"hook_traits.hpp"
+#include<cstddef>
+#include<functional>
+#include<iterator>
+#include<type_traits>
+#include<utility>
+
+namespace ra::intrusive {
+
+	// Per-node management information for the red-black tree of a set
+	// (i.e., the parent and children of the node, and its color).
+	// A hook that is not in a set has a null parent. Copying a hook never
+	// copies its links: a copy starts out unlinked, and assigning to a
+	// hook leaves it unchanged.
+	class set_hook {
+		public:
+			set_hook() noexcept : parent_(nullptr), left_(nullptr), right_(nullptr), red_(false) {}
+			set_hook(const set_hook&) noexcept : set_hook() {}
+			set_hook& operator=(const set_hook&) noexcept { return *this; }
+			~set_hook() = default;
+
+			// Returns true if the node is in a set.
+			// Time complexity: Constant.
+			bool is_linked() const noexcept { return parent_ != nullptr; }
+
+			friend class rbtree_algorithms;
+			template <class T, auto Hook, class Compare, bool Multi>
+			friend class set;
+		private:
+			set_hook* parent_;
+			set_hook* left_;
+			set_hook* right_;
+			bool red_;
+	};
+
+	// The red-black tree algorithms used by set, which operate on hooks
+	// only (and so are not instantiated for each element type).
+	// A tree has a header node, which is red (unlike the root), and whose
+	// parent is the root (or null, if the tree is empty) and whose left and
+	// right children are the leftmost and rightmost nodes (or the header
+	// itself). The parent of the root is the header, so that the header is
+	// the end of an in-order traversal.
+	class rbtree_algorithms {
+		public:
+			// Initializes the header of an empty tree.
+			static void init_header(set_hook& header) noexcept {
+				header.parent_ = nullptr;
+				header.left_ = &header;
+				header.right_ = &header;
+				header.red_ = true;
+			}
+
+			// Returns the node following x in order (the header follows the
+			// rightmost node).
+			static set_hook* next(set_hook* x) noexcept {
+				if(x->right_){
+					x = x->right_;
+					while(x->left_){
+						x = x->left_;
+					}
+				}
+				else{
+					set_hook* y = x->parent_;
+					while(x == y->right_){
+						x = y;
+						y = y->parent_;
+					}
+					// If x is the root and has no right child, y is the
+					// header (whose right child is x).
+					if(x->right_ != y){
+						x = y;
+					}
+				}
+				return x;
+			}
+
+			// Returns the node preceding x in order (the rightmost node
+			// precedes the header).
+			static set_hook* prev(set_hook* x) noexcept {
+				if(x->red_ && x->parent_->parent_ == x){
+					x = x->right_;
+				}
+				else if(x->left_){
+					x = x->left_;
+					while(x->right_){
+						x = x->right_;
+					}
+				}
+				else{
+					set_hook* y = x->parent_;
+					while(x == y->left_){
+						x = y;
+						y = y->parent_;
+					}
+					x = y;
+				}
+				return x;
+			}
+
+			// Links x as the left (if insert_left) or right child of p,
+			// which has no such child (or is the header of an empty tree),
+			// and rebalances the tree.
+			// Time complexity: Logarithmic (amortized constant).
+			static void insert_and_rebalance(bool insert_left, set_hook* x, set_hook* p,
+			  set_hook& header) noexcept {
+				x->parent_ = p;
+				x->left_ = nullptr;
+				x->right_ = nullptr;
+				x->red_ = true;
+				if(insert_left){
+					p->left_ = x;
+					if(p == &header){
+						header.parent_ = x;
+						header.right_ = x;
+					}
+					else if(p == header.left_){
+						header.left_ = x;
+					}
+				}
+				else{
+					p->right_ = x;
+					if(p == header.right_){
+						header.right_ = x;
+					}
+				}
+				set_hook*& root = header.parent_;
+				while(x != root && x->parent_->red_){
+					set_hook* xpp = x->parent_->parent_;
+					if(x->parent_ == xpp->left_){
+						set_hook* y = xpp->right_;
+						if(y && y->red_){
+							x->parent_->red_ = false;
+							y->red_ = false;
+							xpp->red_ = true;
+							x = xpp;
+						}
+						else{
+							if(x == x->parent_->right_){
+								x = x->parent_;
+								rotate_left(x, root);
+							}
+							x->parent_->red_ = false;
+							xpp->red_ = true;
+							rotate_right(xpp, root);
+						}
+					}
+					else{
+						set_hook* y = xpp->left_;
+						if(y && y->red_){
+							x->parent_->red_ = false;
+							y->red_ = false;
+							xpp->red_ = true;
+							x = xpp;
+						}
+						else{
+							if(x == x->parent_->left_){
+								x = x->parent_;
+								rotate_right(x, root);
+							}
+							x->parent_->red_ = false;
+							xpp->red_ = true;
+							rotate_left(xpp, root);
+						}
+					}
+				}
+				root->red_ = false;
+			}
+
+			// Unlinks z from the tree, rebalances the tree, and resets z.
+			// Time complexity: Logarithmic (amortized constant, plus the
+			// time to find the successor of a node with two children).
+			static void erase_and_rebalance(set_hook* z, set_hook& header) noexcept {
+				set_hook*& root = header.parent_;
+				set_hook*& leftmost = header.left_;
+				set_hook*& rightmost = header.right_;
+				set_hook* y = z;
+				set_hook* x = nullptr;
+				set_hook* x_parent = nullptr;
+				if(!y->left_){
+					x = y->right_;
+				}
+				else if(!y->right_){
+					x = y->left_;
+				}
+				else{
+					y = y->right_;
+					while(y->left_){
+						y = y->left_;
+					}
+					x = y->right_;
+				}
+				if(y != z){
+					// Put z's successor y in the place of z.
+					z->left_->parent_ = y;
+					y->left_ = z->left_;
+					if(y != z->right_){
+						x_parent = y->parent_;
+						if(x){
+							x->parent_ = y->parent_;
+						}
+						y->parent_->left_ = x;
+						y->right_ = z->right_;
+						z->right_->parent_ = y;
+					}
+					else{
+						x_parent = y;
+					}
+					replace_child(z, y, root);
+					y->parent_ = z->parent_;
+					std::swap(y->red_, z->red_);
+				}
+				else{
+					x_parent = y->parent_;
+					if(x){
+						x->parent_ = y->parent_;
+					}
+					replace_child(z, x, root);
+					if(leftmost == z){
+						leftmost = z->right_ ? minimum(x) : z->parent_;
+					}
+					if(rightmost == z){
+						rightmost = z->left_ ? maximum(x) : z->parent_;
+					}
+				}
+				// The node removed from the tree has z's color now.
+				if(!z->red_){
+					while(x != root && (!x || !x->red_)){
+						if(x == x_parent->left_){
+							set_hook* w = x_parent->right_;
+							if(w->red_){
+								w->red_ = false;
+								x_parent->red_ = true;
+								rotate_left(x_parent, root);
+								w = x_parent->right_;
+							}
+							if(!is_red(w->left_) && !is_red(w->right_)){
+								w->red_ = true;
+								x = x_parent;
+								x_parent = x_parent->parent_;
+							}
+							else{
+								if(!is_red(w->right_)){
+									w->left_->red_ = false;
+									w->red_ = true;
+									rotate_right(w, root);
+									w = x_parent->right_;
+								}
+								w->red_ = x_parent->red_;
+								x_parent->red_ = false;
+								if(w->right_){
+									w->right_->red_ = false;
+								}
+								rotate_left(x_parent, root);
+								break;
+							}
+						}
+						else{
+							set_hook* w = x_parent->left_;
+							if(w->red_){
+								w->red_ = false;
+								x_parent->red_ = true;
+								rotate_right(x_parent, root);
+								w = x_parent->left_;
+							}
+							if(!is_red(w->right_) && !is_red(w->left_)){
+								w->red_ = true;
+								x = x_parent;
+								x_parent = x_parent->parent_;
+							}
+							else{
+								if(!is_red(w->left_)){
+									w->right_->red_ = false;
+									w->red_ = true;
+									rotate_left(w, root);
+									w = x_parent->left_;
+								}
+								w->red_ = x_parent->red_;
+								x_parent->red_ = false;
+								if(w->left_){
+									w->left_->red_ = false;
+								}
+								rotate_right(x_parent, root);
+								break;
+							}
+						}
+					}
+					if(x){
+						x->red_ = false;
+					}
+				}
+				reset(z);
+			}
+
+			// Unlinks all nodes from the tree (in post-order, without
+			// rebalancing), resetting each node and then passing it to
+			// disposer, and leaves the tree empty.
+			// Time complexity: Linear in the number of nodes.
+			template <class Disposer>
+			static void clear_and_dispose(set_hook& header, Disposer disposer) {
+				set_hook* x = header.parent_;
+				while(x){
+					if(x->left_){
+						x = x->left_;
+					}
+					else if(x->right_){
+						x = x->right_;
+					}
+					else{
+						set_hook* p = x->parent_;
+						if(p == &header){
+							p = nullptr;
+						}
+						else if(p->left_ == x){
+							p->left_ = nullptr;
+						}
+						else{
+							p->right_ = nullptr;
+						}
+						reset(x);
+						disposer(x);
+						x = p;
+					}
+				}
+				init_header(header);
+			}
+
+			// Returns the number of black nodes on every path from x to a
+			// leaf, or -1 if the subtree rooted at x is not a valid
+			// red-black tree (with correct parent links).
+			static int black_height(const set_hook* x) noexcept {
+				if(!x){
+					return 1;
+				}
+				if((x->left_ && x->left_->parent_ != x) || (x->right_ && x->right_->parent_ != x)){
+					return -1;
+				}
+				if(x->red_ && (is_red(x->left_) || is_red(x->right_))){
+					return -1;
+				}
+				int left = black_height(x->left_);
+				int right = black_height(x->right_);
+				if(left < 0 || left != right){
+					return -1;
+				}
+				return left + (x->red_ ? 0 : 1);
+			}
+
+		private:
+			static bool is_red(const set_hook* x) noexcept { return x && x->red_; }
+
+			static set_hook* minimum(set_hook* x) noexcept {
+				while(x->left_){
+					x = x->left_;
+				}
+				return x;
+			}
+			static set_hook* maximum(set_hook* x) noexcept {
+				while(x->right_){
+					x = x->right_;
+				}
+				return x;
+			}
+
+			static void reset(set_hook* x) noexcept {
+				x->parent_ = nullptr;
+				x->left_ = nullptr;
+				x->right_ = nullptr;
+				x->red_ = false;
+			}
+
+			// Makes y take the place of the child z of z's parent (or of the
+			// root).
+			static void replace_child(set_hook* z, set_hook* y, set_hook*& root) noexcept {
+				if(root == z){
+					root = y;
+				}
+				else if(z->parent_->left_ == z){
+					z->parent_->left_ = y;
+				}
+				else{
+					z->parent_->right_ = y;
+				}
+			}
+
+			static void rotate_left(set_hook* x, set_hook*& root) noexcept {
+				set_hook* y = x->right_;
+				x->right_ = y->left_;
+				if(y->left_){
+					y->left_->parent_ = x;
+				}
+				y->parent_ = x->parent_;
+				replace_child(x, y, root);
+				y->left_ = x;
+				x->parent_ = y;
+			}
+			static void rotate_right(set_hook* x, set_hook*& root) noexcept {
+				set_hook* y = x->left_;
+				x->left_ = y->right_;
+				if(y->right_){
+					y->right_->parent_ = x;
+				}
+				y->parent_ = x->parent_;
+				replace_child(x, y, root);
+				y->right_ = x;
+				x->parent_ = y;
+			}
+	};
+
+	// Intrusive ordered set (a red-black tree), whose elements are objects
+	// of type T ordered by Compare. Hook is either a pointer to the
+	// set_hook data member of T, or base_hook if T is derived from
+	// set_hook. The elements are owned by the caller; the set never
+	// allocates memory, and an element can be erased given only a
+	// reference to it. An element can be on several sets (ordered
+	// differently) at once through different hooks.
+	// If Multi is true, the set may hold several equivalent elements
+	// (which are kept in the order they were inserted); see multiset.
+	// If Compare has a member type is_transparent, elements can be looked
+	// up by any key type that it accepts (heterogeneous lookup).
+	// Elements must be erased from the set before they are destroyed, and
+	// must not be modified in a way that changes their order.
+	template <class T, auto Hook, class Compare = std::less<T>, bool Multi = false>
+	class set {
+		private:
+			// Lookups accept the value type, and other types only if
+			// Compare is transparent.
+			template <class K, class C = Compare, class = void>
+			struct lookup_key {};
+			template <class K, class C>
+			struct lookup_key<K, C, std::enable_if_t<std::is_convertible_v<const K&, const T&>>> {
+				using type = void;
+			};
+			template <class K, class C>
+			struct lookup_key<K, C, std::enable_if_t<!std::is_convertible_v<const K&, const T&>,
+			  std::void_t<typename C::is_transparent>>> {
+				using type = void;
+			};
+			template <class K>
+			using lookup_key_t = typename lookup_key<K>::type;
+
+		public:
+			// The conversions between elements and their hooks.
+			using hook_traits = ra::intrusive::hook_traits<T, Hook, set_hook>;
+			static_assert(std::is_base_of_v<set_hook, typename hook_traits::hook_type>,
+			  "the hook of a set must be a data member of type set_hook");
+
+			// The type of the elements in the set.
+			using value_type = T;
+
+			// The type of the comparison function.
+			using value_compare = Compare;
+
+			// The type of a mutating reference to an element.
+			using reference = T&;
+
+			// The type of a non-mutating reference to an element.
+			using const_reference = const T&;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// A signed integral type used to represent distances between
+			// iterators.
+			using difference_type = std::ptrdiff_t;
+
+			// The non-mutating iterator class. An iterator is a single
+			// pointer to the hook of the element it refers to (or to the
+			// header), and is trivially copyable.
+			class set_const_iterator {
+				public:
+					using value_type = T;
+					using iterator_category = std::bidirectional_iterator_tag;
+					using difference_type = std::ptrdiff_t;
+					using pointer = const T*;
+					using reference = const T&;
+					set_const_iterator() noexcept : ptr_(nullptr) {}
+					explicit set_const_iterator(const set_hook* ptrval) noexcept : ptr_(const_cast<set_hook*>(ptrval)) {}
+					bool operator==(const set_const_iterator& other) const noexcept {
+						return ptr_ == other.ptr_;
+					}
+					bool operator!=(const set_const_iterator& other) const noexcept {
+						return ptr_ != other.ptr_;
+					}
+					const T* operator->() const noexcept {
+						return &value_of(ptr_);
+					}
+					const T& operator*() const noexcept {
+						return value_of(ptr_);
+					}
+					set_const_iterator& operator++() noexcept {
+						ptr_ = rbtree_algorithms::next(ptr_);
+						return *this;
+					}
+					set_const_iterator operator++(int) noexcept {
+						set_const_iterator oldIter(*this);
+						ptr_ = rbtree_algorithms::next(ptr_);
+						return oldIter;
+					}
+					set_const_iterator& operator--() noexcept {
+						ptr_ = rbtree_algorithms::prev(ptr_);
+						return *this;
+					}
+					set_const_iterator operator--(int) noexcept {
+						set_const_iterator oldIter(*this);
+						ptr_ = rbtree_algorithms::prev(ptr_);
+						return oldIter;
+					}
+					const set_hook* getPtr() const noexcept { return ptr_; }
+				private:
+					// Traversal does not modify the nodes, but shares the
+					// algorithms of mutating iterators.
+					set_hook* ptr_;
+			};
+
+			// The mutating iterator class, which converts to the
+			// non-mutating one.
+			class set_iterator {
+				public:
+					using value_type = T;
+					using iterator_category = std::bidirectional_iterator_tag;
+					using difference_type = std::ptrdiff_t;
+					using pointer = T*;
+					using reference = T&;
+					set_iterator() noexcept : ptr_(nullptr) {}
+					explicit set_iterator(set_hook* ptrval) noexcept : ptr_(ptrval) {}
+					operator set_const_iterator() const noexcept { return set_const_iterator(ptr_); }
+					bool operator==(const set_iterator& other) const noexcept {
+						return ptr_ == other.ptr_;
+					}
+					bool operator!=(const set_iterator& other) const noexcept {
+						return ptr_ != other.ptr_;
+					}
+					bool operator==(const set_const_iterator& other) const noexcept {
+						return ptr_ == other.getPtr();
+					}
+					bool operator!=(const set_const_iterator& other) const noexcept {
+						return ptr_ != other.getPtr();
+					}
+					T* operator->() const noexcept {
+						return &value_of(ptr_);
+					}
+					T& operator*() const noexcept {
+						return value_of(ptr_);
+					}
+					set_iterator& operator++() noexcept {
+						ptr_ = rbtree_algorithms::next(ptr_);
+						return *this;
+					}
+					set_iterator operator++(int) noexcept {
+						set_iterator oldIter(*this);
+						ptr_ = rbtree_algorithms::next(ptr_);
+						return oldIter;
+					}
+					set_iterator& operator--() noexcept {
+						ptr_ = rbtree_algorithms::prev(ptr_);
+						return *this;
+					}
+					set_iterator operator--(int) noexcept {
+						set_iterator oldIter(*this);
+						ptr_ = rbtree_algorithms::prev(ptr_);
+						return oldIter;
+					}
+					set_hook* getPtr() const noexcept { return ptr_; }
+				private:
+					set_hook* ptr_;
+			};
+
+			// The (bidirectional) iterator types for the set.
+			using iterator = set_iterator;
+			using const_iterator = set_const_iterator;
+			using reverse_iterator = std::reverse_iterator<iterator>;
+			using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+			// The type returned by insert: an iterator referring to the
+			// inserted element for a multiset, and otherwise also whether
+			// the element was inserted.
+			using insert_return_type = std::conditional_t<Multi, iterator, std::pair<iterator, bool>>;
+
+			// Creates an empty set.
+			// Time complexity: Constant.
+			explicit set(const value_compare& comp = value_compare()) : size_(0), comp_(comp) {
+				rbtree_algorithms::init_header(header_);
+			}
+
+			// Move construction and assignment. The elements of other are
+			// moved to *this (which is cleared first), leaving other empty.
+			// Time complexity: Constant (plus clearing *this).
+			set(set&& other) : size_(0), comp_(other.comp_) {
+				rbtree_algorithms::init_header(header_);
+				take(other);
+			}
+			set& operator=(set&& other) {
+				if(this != &other){
+					clear();
+					comp_ = other.comp_;
+					take(other);
+				}
+				return *this;
+			}
+
+			// Do not allow the copying of sets.
+			set(const set&) = delete;
+			set& operator=(const set&) = delete;
+
+			// Erases any elements from the set and then destroys the set.
+			// Time complexity: Linear in size().
+			~set() {
+				clear();
+			}
+
+			// Returns the number of elements in the set.
+			// Time complexity: Constant.
+			size_type size() const noexcept { return size_; }
+
+			// Returns true if the set has no elements.
+			// Time complexity: Constant.
+			bool empty() const noexcept { return size_ == 0; }
+
+			// Returns the comparison function.
+			// Time complexity: Constant.
+			value_compare value_comp() const { return comp_; }
+
+			// Returns an iterator referring to the first (least) element in
+			// the set if the set is not empty and end() otherwise.
+			// Time complexity: Constant.
+			iterator begin() noexcept { return iterator(header_.left_); }
+			const_iterator begin() const noexcept { return const_iterator(header_.left_); }
+
+			// Returns an iterator referring to the fictitious one-past-the-end
+			// element.
+			// Time complexity: Constant.
+			iterator end() noexcept { return iterator(&header_); }
+			const_iterator end() const noexcept { return const_iterator(&header_); }
+
+			// Returns reverse iterators over the elements, from the greatest
+			// to the least.
+			// Time complexity: Constant.
+			reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+			const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+			reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+			const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+			// Returns an iterator referring to the element x, which must be
+			// in a set of this type (not necessarily *this).
+			// Time complexity: Constant.
+			iterator iterator_to(reference x) noexcept { return s_iterator_to(x); }
+			const_iterator iterator_to(const_reference x) const noexcept { return s_iterator_to(x); }
+			static iterator s_iterator_to(reference x) noexcept {
+				return iterator(hook_traits::to_hook(&x));
+			}
+			static const_iterator s_iterator_to(const_reference x) noexcept {
+				return const_iterator(hook_traits::to_hook(&x));
+			}
+
+			// Inserts the element x. Unless Multi is true, x is inserted
+			// only if the set has no element equivalent to x; an iterator
+			// referring to the equivalent element (or to x) is returned,
+			// together with whether x was inserted. In a multiset, x is
+			// inserted after any equivalent elements.
+			// Precondition: x is not in a set through Hook.
+			// Time complexity: Logarithmic.
+			insert_return_type insert(reference x) {
+				set_hook* y = &header_;
+				set_hook* z = header_.parent_;
+				bool less = true;
+				while(z){
+					y = z;
+					less = comp_(x, value_of(z));
+					z = less ? z->left_ : z->right_;
+				}
+				if constexpr(Multi){
+					return link(x, y, less);
+				}
+				else{
+					iterator j(y);
+					if(less){
+						if(j == begin()){
+							return std::pair<iterator, bool>(link(x, y, less), true);
+						}
+						--j;
+					}
+					if(comp_(*j, x)){
+						return std::pair<iterator, bool>(link(x, y, less), true);
+					}
+					return std::pair<iterator, bool>(j, false);
+				}
+			}
+
+			// Erases the element referred to by pos. Returns an iterator
+			// referring to the element following the erased element.
+			// Time complexity: Amortized constant (no search is needed),
+			// plus finding the successor of pos.
+			iterator erase(const_iterator pos) noexcept {
+				set_hook* x = const_cast<set_hook*>(pos.getPtr());
+				iterator next(rbtree_algorithms::next(x));
+				rbtree_algorithms::erase_and_rebalance(x, header_);
+				--size_;
+				return next;
+			}
+
+			// Erases the element x.
+			// Precondition: x is in the set.
+			// Time complexity: Amortized constant (no search is needed),
+			// plus logarithmic if x has two children in the tree.
+			void erase(reference x) noexcept {
+				rbtree_algorithms::erase_and_rebalance(hook_traits::to_hook(&x), header_);
+				--size_;
+			}
+
+			// Erases the elements in the range [first, last). Returns an
+			// iterator referring to last.
+			// Time complexity: Logarithmic times the number of elements
+			// erased.
+			iterator erase(const_iterator first, const_iterator last) noexcept {
+				while(first != last){
+					first = erase(first);
+				}
+				return iterator(const_cast<set_hook*>(last.getPtr()));
+			}
+
+			// Erases the elements equivalent to k. Returns the number of
+			// elements erased.
+			// Time complexity: Logarithmic plus the number of elements
+			// erased.
+			template <class K, class = lookup_key_t<K>>
+			size_type erase_key(const K& k) {
+				std::pair<iterator, iterator> range = equal_range(k);
+				size_type n = 0;
+				for(iterator i = range.first; i != range.second; ++n){
+					i = erase(i);
+				}
+				return n;
+			}
+
+			// Erases the element referred to by pos and passes it to
+			// disposer (with its hook already reset). Returns an iterator
+			// referring to the element following the erased element.
+			// Time complexity: As for erase (plus the disposer).
+			template <class Disposer>
+			iterator erase_and_dispose(const_iterator pos, Disposer disposer) {
+				value_type* x = &value_of(const_cast<set_hook*>(pos.getPtr()));
+				iterator next = erase(pos);
+				disposer(x);
+				return next;
+			}
+
+			// Erases all of the elements, resetting their hooks.
+			// Time complexity: Linear in size().
+			void clear() noexcept {
+				clear_and_dispose([](value_type*) {});
+			}
+
+			// Erases all of the elements and passes each of them (in no
+			// particular order, with its hook already reset) to disposer.
+			// Time complexity: Linear in size() (plus the disposer).
+			template <class Disposer>
+			void clear_and_dispose(Disposer disposer) {
+				rbtree_algorithms::clear_and_dispose(header_, [&disposer](set_hook* h) {
+					disposer(&value_of(h));
+				});
+				size_ = 0;
+			}
+
+			// The following functions look up elements equivalent to k,
+			// which is an element or (if Compare is transparent) any key
+			// that Compare accepts.
+
+			// Returns an iterator referring to the first element not less
+			// than k, or end() if there is none.
+			// Time complexity: Logarithmic.
+			template <class K, class = lookup_key_t<K>>
+			iterator lower_bound(const K& k) { return iterator(lower_bound_hook(k)); }
+			template <class K, class = lookup_key_t<K>>
+			const_iterator lower_bound(const K& k) const { return const_iterator(lower_bound_hook(k)); }
+
+			// Returns an iterator referring to the first element greater
+			// than k, or end() if there is none.
+			// Time complexity: Logarithmic.
+			template <class K, class = lookup_key_t<K>>
+			iterator upper_bound(const K& k) { return iterator(upper_bound_hook(k)); }
+			template <class K, class = lookup_key_t<K>>
+			const_iterator upper_bound(const K& k) const { return const_iterator(upper_bound_hook(k)); }
+
+			// Returns an iterator referring to an element equivalent to k
+			// (the first one, in a multiset), or end() if there is none.
+			// Time complexity: Logarithmic.
+			template <class K, class = lookup_key_t<K>>
+			iterator find(const K& k) {
+				iterator i = lower_bound(k);
+				return (i == end() || comp_(k, *i)) ? end() : i;
+			}
+			template <class K, class = lookup_key_t<K>>
+			const_iterator find(const K& k) const {
+				const_iterator i = lower_bound(k);
+				return (i == end() || comp_(k, *i)) ? end() : i;
+			}
+
+			// Returns true if the set has an element equivalent to k.
+			// Time complexity: Logarithmic.
+			template <class K, class = lookup_key_t<K>>
+			bool contains(const K& k) const { return find(k) != end(); }
+
+			// Returns the range of elements equivalent to k.
+			// Time complexity: Logarithmic.
+			template <class K, class = lookup_key_t<K>>
+			std::pair<iterator, iterator> equal_range(const K& k) {
+				return std::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+			}
+			template <class K, class = lookup_key_t<K>>
+			std::pair<const_iterator, const_iterator> equal_range(const K& k) const {
+				return std::pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+			}
+
+			// Returns the number of elements equivalent to k.
+			// Time complexity: Logarithmic plus the number of elements
+			// counted.
+			template <class K, class = lookup_key_t<K>>
+			size_type count(const K& k) const {
+				std::pair<const_iterator, const_iterator> range = equal_range(k);
+				return size_type(std::distance(range.first, range.second));
+			}
+
+			// Returns true if the tree satisfies the red-black properties
+			// and its size, order and links are consistent (for testing).
+			// Time complexity: Linear in size().
+			bool verify() const noexcept {
+				const set_hook* root = header_.parent_;
+				if(!root){
+					return size_ == 0 && header_.left_ == &header_ && header_.right_ == &header_;
+				}
+				if(root->red_ || root->parent_ != &header_ ||
+				  rbtree_algorithms::black_height(root) < 0){
+					return false;
+				}
+				size_type n = 0;
+				for(const_iterator i = begin(); i != end(); ++i, ++n){
+					const_iterator j = i;
+					if(++j != end() && (Multi ? comp_(*j, *i) : !comp_(*i, *j))){
+						return false;
+					}
+				}
+				return n == size_;
+			}
+
+		private:
+			// Returns the element containing the hook h.
+			static reference value_of(set_hook* h) noexcept {
+				return *hook_traits::to_value(static_cast<typename hook_traits::hook_type*>(h));
+			}
+			static const_reference value_of(const set_hook* h) noexcept {
+				return *hook_traits::to_value(static_cast<const typename hook_traits::hook_type*>(h));
+			}
+
+			// Links x as the left (if insert_left) or right child of p.
+			iterator link(reference x, set_hook* p, bool insert_left) noexcept {
+				set_hook* h = hook_traits::to_hook(&x);
+				rbtree_algorithms::insert_and_rebalance(insert_left || p == &header_, h, p, header_);
+				++size_;
+				return iterator(h);
+			}
+
+			template <class K>
+			set_hook* lower_bound_hook(const K& k) const {
+				set_hook* y = const_cast<set_hook*>(&header_);
+				set_hook* x = header_.parent_;
+				while(x){
+					if(!comp_(value_of(x), k)){
+						y = x;
+						x = x->left_;
+					}
+					else{
+						x = x->right_;
+					}
+				}
+				return y;
+			}
+			template <class K>
+			set_hook* upper_bound_hook(const K& k) const {
+				set_hook* y = const_cast<set_hook*>(&header_);
+				set_hook* x = header_.parent_;
+				while(x){
+					if(comp_(k, value_of(x))){
+						y = x;
+						x = x->left_;
+					}
+					else{
+						x = x->right_;
+					}
+				}
+				return y;
+			}
+
+			// Moves the tree of other (with the same comparison function)
+			// into *this, which is empty.
+			void take(set& other) noexcept {
+				if(other.header_.parent_){
+					header_.parent_ = other.header_.parent_;
+					header_.left_ = other.header_.left_;
+					header_.right_ = other.header_.right_;
+					header_.parent_->parent_ = &header_;
+					size_ = other.size_;
+					rbtree_algorithms::init_header(other.header_);
+					other.size_ = 0;
+				}
+			}
+
+			set_hook header_;
+			size_type size_;
+			[[no_unique_address]] value_compare comp_;
+	};
+
+	// An intrusive ordered set that may hold several equivalent elements.
+	template <class T, auto Hook, class Compare = std::less<T>>
+	using multiset = set<T, Hook, Compare, true>;
+
+}
+#endif
@@ -0,0 +1,344 @@
+#ifndef LRUCACHEHPP
+#define LRUCACHEHPP
+
+#include"intrusive_list.hpp"
+#include"unordered_set.hpp"
+#include<cstddef>
+#include<cstdint>
+#include<functional>
+#include<mutex>
+#include<type_traits>
+#include<utility>
+#include<vector>
+
+namespace ra::intrusive {
+
+	// An intrusive cache with least-recently-used eviction.
+	// Each entry (an object of type T) holds its own key, the data member
+	// Key of T, and two list hooks: LruHook, which links the entries in
+	// order of recency, and HashHook, which links the entries in the same
+	// bucket of a chained hash index. The cache never allocates memory
+	// after it is created; it only links and unlinks entries, which are
+	// owned by the caller. Looking up an entry moves it to the front of the
+	// recency order; when an insertion exceeds the capacity, the least
+	// recently used entry is unlinked and handed to a disposer (e.g., to
+	// return it to a pool). The hash index is an unordered_set over a
+	// bucket array owned by the cache.
+	// The hooks must be list_hook members, and entries must be erased from
+	// the cache before they are destroyed.
+	template <class T, auto Key, auto LruHook, auto HashHook,
+	  class Hash = std::hash<std::remove_cv_t<std::remove_reference_t<decltype(std::declval<T&>().*Key)>>>,
+	  class KeyEqual = std::equal_to<std::remove_cv_t<std::remove_reference_t<decltype(std::declval<T&>().*Key)>>>>
+	class lru_cache {
+		public:
+			// The type of the entries in the cache.
+			using value_type = T;
+
+			// The type of the keys.
+			using key_type = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<T&>().*Key)>>;
+
+			// The types of the hash function and key equality predicate.
+			using hasher = Hash;
+			using key_equal = KeyEqual;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// The type of the list of entries in order of recency (most
+			// recently used first).
+			using lru_list_type = list<T, LruHook>;
+			static_assert(!list_hook_traits<T, LruHook>::hook_type::auto_unlink &&
+			  !list_hook_traits<T, HashHook>::hook_type::auto_unlink,
+			  "the hooks of an lru_cache must be list_hook members (an entry that unlinked itself would be left in the cache)");
+
+			// Creates an empty cache that holds at most capacity entries.
+			// The hash index has a power-of-two number of buckets (at least
+			// two), not less than bucket_count (or capacity, if bucket_count
+			// is zero).
+			// Time complexity: Linear in the number of buckets.
+			explicit lru_cache(size_type capacity, size_type bucket_count = 0,
+			  const hasher& hash = hasher(), const key_equal& equal = key_equal()) :
+			  capacity_(capacity), buckets_(buckets_for(bucket_count ? bucket_count : capacity)),
+			  index_(buckets_.data(), buckets_.size(), entry_hash{hash}, entry_equal{equal}) {}
+
+			// Caches cannot be copied (their entries can be in only one
+			// cache) or moved (the index refers to the bucket array of the
+			// cache).
+			lru_cache(const lru_cache&) = delete;
+			lru_cache& operator=(const lru_cache&) = delete;
+
+			// Destroys the cache. The entries are erased (resetting their
+			// hooks) but not disposed of.
+			// Time complexity: Linear in size() plus the number of buckets.
+			~lru_cache() {
+				clear();
+			}
+
+			// Returns the number of entries in the cache.
+			// Time complexity: Constant.
+			size_type size() const noexcept { return lru_.size(); }
+
+			// Returns true if the cache has no entries.
+			// Time complexity: Constant.
+			bool empty() const noexcept { return lru_.empty(); }
+
+			// Returns the maximum number of entries in the cache.
+			// Time complexity: Constant.
+			size_type capacity() const noexcept { return capacity_; }
+
+			// Returns the number of buckets in the hash index.
+			// Time complexity: Constant.
+			size_type bucket_count() const noexcept { return index_.bucket_count(); }
+
+			// Returns the entries in order of recency (most recently used
+			// first). The list must not be modified.
+			// Time complexity: Constant.
+			const lru_list_type& entries() const noexcept { return lru_; }
+
+			// Returns a pointer to the entry with the key k, and makes it
+			// the most recently used entry, or returns nullptr if there is
+			// no such entry.
+			// Time complexity: Constant on average.
+			value_type* get(const key_type& k) {
+				typename index_type::iterator i = index_.find(k);
+				if(i == index_.end()){
+					return nullptr;
+				}
+				lru_.splice(lru_.iterator_to(lru_.front()), lru_, lru_.iterator_to(*i));
+				return &*i;
+			}
+
+			// Returns a pointer to the entry with the key k without changing
+			// the recency order, or returns nullptr if there is no such
+			// entry.
+			// Time complexity: Constant on average.
+			const value_type* peek(const key_type& k) const {
+				typename index_type::const_iterator i = index_.find(k);
+				return i == index_.end() ? nullptr : &*i;
+			}
+
+			// Inserts the entry x as the most recently used entry, unless
+			// the cache already has an entry with the same key. If the
+			// insertion makes the cache exceed its capacity, the least
+			// recently used entry is erased and passed to disposer.
+			// Returns a pointer to the entry with the key of x and whether
+			// x was inserted. If x itself is erased (i.e., the capacity is
+			// zero), returns a null pointer and false.
+			// Precondition: x is not in a list through LruHook or HashHook.
+			// Time complexity: Constant on average.
+			template <class Disposer>
+			std::pair<value_type*, bool> insert(value_type& x, Disposer disposer) {
+				std::pair<typename index_type::iterator, bool> res = index_.insert(x);
+				if(!res.second){
+					return std::pair<value_type*, bool>(&*res.first, false);
+				}
+				lru_.push_front(x);
+				if(lru_.size() > capacity_){
+					bool evicts_x = &lru_.back() == &x;
+					evict(disposer);
+					if(evicts_x){
+						return std::pair<value_type*, bool>(nullptr, false);
+					}
+				}
+				return std::pair<value_type*, bool>(&x, true);
+			}
+
+			// Erases the entry x from the cache (without disposing of it).
+			// Precondition: x is in the cache.
+			// Time complexity: Constant.
+			void erase(value_type& x) {
+				index_.erase(x);
+				lru_.erase(lru_.iterator_to(x));
+			}
+
+			// Erases the entry with the key k, if there is one, and passes
+			// it to disposer. Returns true if an entry was erased.
+			// Time complexity: Constant on average.
+			template <class Disposer>
+			bool erase(const key_type& k, Disposer disposer) {
+				typename index_type::iterator i = index_.find(k);
+				if(i == index_.end()){
+					return false;
+				}
+				value_type& x = *i;
+				erase(x);
+				disposer(&x);
+				return true;
+			}
+
+			// Erases the least recently used entry and passes it to disposer.
+			// Precondition: The cache is not empty.
+			// Time complexity: Constant.
+			template <class Disposer>
+			void evict(Disposer disposer) {
+				index_.erase(lru_.back());
+				lru_.pop_back_and_dispose(disposer);
+			}
+
+			// Erases all entries (without disposing of them).
+			// Time complexity: Linear in size() plus the number of buckets.
+			void clear() {
+				clear_and_dispose([](value_type*) {});
+			}
+
+			// Erases all entries and passes each of them to disposer.
+			// Time complexity: Linear in size() plus the number of buckets.
+			template <class Disposer>
+			void clear_and_dispose(Disposer disposer) {
+				index_.clear();
+				lru_.clear_and_dispose(disposer);
+			}
+
+		private:
+			// The hash function and equality predicate of the index, which
+			// apply Hash and KeyEqual to the keys of entries, and accept
+			// keys for lookups.
+			struct entry_hash {
+				using is_transparent = void;
+				size_type operator()(const value_type& x) const { return hash(x.*Key); }
+				size_type operator()(const key_type& k) const { return hash(k); }
+				[[no_unique_address]] hasher hash;
+			};
+			struct entry_equal {
+				using is_transparent = void;
+				bool operator()(const value_type& x, const value_type& y) const { return equal(x.*Key, y.*Key); }
+				bool operator()(const value_type& x, const key_type& k) const { return equal(x.*Key, k); }
+				[[no_unique_address]] key_equal equal;
+			};
+
+			using index_type = unordered_set<T, HashHook, entry_hash, entry_equal>;
+			using bucket_type = typename index_type::bucket_type;
+
+			// Returns a power-of-two number (at least two) of buckets, not
+			// less than n.
+			static std::vector<bucket_type> buckets_for(size_type n) {
+				size_type count = 2;
+				while(count < n){
+					count *= 2;
+				}
+				return std::vector<bucket_type>(count);
+			}
+
+			size_type capacity_;
+			std::vector<bucket_type> buckets_;
+			index_type index_;
+			lru_list_type lru_;
+	};
+
+	// An lru_cache partitioned into Shards independent caches (each with
+	// its own mutex), for use by multiple threads. The shard of an entry is
+	// chosen by its hash value, so that threads using different keys rarely
+	// contend.
+	// Since another thread may evict an entry at any time once the shard is
+	// unlocked, entries are accessed through callbacks that run with the
+	// shard locked. Disposers also run with the shard locked.
+	template <class T, auto Key, auto LruHook, auto HashHook, std::size_t Shards = 16,
+	  class Hash = std::hash<std::remove_cv_t<std::remove_reference_t<decltype(std::declval<T&>().*Key)>>>,
+	  class KeyEqual = std::equal_to<std::remove_cv_t<std::remove_reference_t<decltype(std::declval<T&>().*Key)>>>>
+	class sharded_lru_cache {
+		static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0,
+		  "the number of shards must be a power of two");
+		public:
+			// The type of each shard's cache.
+			using shard_type = lru_cache<T, Key, LruHook, HashHook, Hash, KeyEqual>;
+
+			using value_type = T;
+			using key_type = typename shard_type::key_type;
+			using hasher = Hash;
+			using size_type = std::size_t;
+
+			// Creates an empty cache that holds at most capacity entries
+			// (divided evenly among the shards).
+			// Time complexity: Linear in capacity.
+			explicit sharded_lru_cache(size_type capacity, const hasher& hash = hasher()) :
+			  sharded_lru_cache((capacity + Shards - 1) / Shards, hash, std::make_index_sequence<Shards>()) {}
+
+			sharded_lru_cache(const sharded_lru_cache&) = delete;
+			sharded_lru_cache& operator=(const sharded_lru_cache&) = delete;
+
+			// Returns the total number of entries in the cache.
+			// Time complexity: Linear in Shards.
+			size_type size() const {
+				size_type n = 0;
+				for(const shard& s : shards_){
+					std::lock_guard<std::mutex> lock(s.mutex);
+					n += s.cache.size();
+				}
+				return n;
+			}
+
+			// If there is an entry with the key k, makes it the most
+			// recently used entry of its shard and calls f with a reference
+			// to it. Returns true if there was an entry.
+			// Time complexity: Constant on average.
+			template <class F>
+			bool get(const key_type& k, F f) {
+				shard& s = shard_for(k);
+				std::lock_guard<std::mutex> lock(s.mutex);
+				value_type* x = s.cache.get(k);
+				if(x){
+					f(*x);
+				}
+				return x != nullptr;
+			}
+
+			// Inserts the entry x (see lru_cache::insert). Returns true if x
+			// was inserted.
+			// Time complexity: Constant on average.
+			template <class Disposer>
+			bool insert(value_type& x, Disposer disposer) {
+				shard& s = shard_for(x.*Key);
+				std::lock_guard<std::mutex> lock(s.mutex);
+				return s.cache.insert(x, disposer).second;
+			}
+
+			// Erases the entry with the key k, if there is one, and passes
+			// it to disposer. Returns true if an entry was erased.
+			// Time complexity: Constant on average.
+			template <class Disposer>
+			bool erase(const key_type& k, Disposer disposer) {
+				shard& s = shard_for(k);
+				std::lock_guard<std::mutex> lock(s.mutex);
+				return s.cache.erase(k, disposer);
+			}
+
+			// Erases all entries and passes each of them to disposer.
+			// Time complexity: Linear in size() plus the number of buckets.
+			template <class Disposer>
+			void clear_and_dispose(Disposer disposer) {
+				for(shard& s : shards_){
+					std::lock_guard<std::mutex> lock(s.mutex);
+					s.cache.clear_and_dispose(disposer);
+				}
+			}
+
+		private:
+			// Each shard is on its own cache lines, so that threads using
+			// different shards do not contend for the same line.
+			struct alignas(64) shard {
+				shard(size_type capacity, const hasher& hash) : cache(capacity, 0, hash) {}
+				mutable std::mutex mutex;
+				shard_type cache;
+			};
+
+			// Constructs each shard in place (shards cannot be moved) with
+			// a capacity of shard_capacity.
+			template <std::size_t... I>
+			sharded_lru_cache(size_type shard_capacity, const hasher& hash, std::index_sequence<I...>) :
+			  hash_(hash), shards_{((void)I, shard(shard_capacity, hash))...} {}
+
+			// Chooses the shard from the high bits of the hash value mixed
+			// with a different multiplier than the one the caches use to
+			// choose buckets (so that the keys in a shard still spread over
+			// all of its buckets).
+			shard& shard_for(const key_type& k) {
+				std::uint64_t h = std::uint64_t(hash_(k)) * 0xbf58476d1ce4e5b9u;
+				return shards_[Shards == 1 ? 0 : size_type(h >> (64 - __builtin_ctzll(Shards)))];
+			}
+
+			[[no_unique_address]] hasher hash_;
+			shard shards_[Shards];
+	};
+
+}
+#endif
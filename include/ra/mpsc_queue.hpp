@@ -0,0 +1,159 @@
+#ifndef MPSCQUEUEHPP
+#define MPSCQUEUEHPP
+
+#include"parent_from_member.hpp"
+#include"intrusive_list.hpp"
+#include<atomic>
+#include<cstddef>
+
+namespace ra::intrusive {
+
+	// Per-node management information for mpsc_queue (i.e., the
+	// successor of the node in the queue).
+	// A node that is not in a queue may be copied or assigned freely;
+	// copying a hook never copies its link.
+	class mpsc_hook {
+		public:
+			mpsc_hook() noexcept : next_(nullptr) {}
+			mpsc_hook(const mpsc_hook&) noexcept : next_(nullptr) {}
+			mpsc_hook& operator=(const mpsc_hook&) noexcept { return *this; }
+			~mpsc_hook() = default;
+			template<class T, mpsc_hook T::* Hook>
+			friend class mpsc_queue;
+		private:
+			std::atomic<mpsc_hook*> next_;
+	};
+
+	// Intrusive lock-free multi-producer single-consumer FIFO queue
+	// (Vyukov's algorithm).
+	// Any number of threads may call push concurrently; only one thread
+	// at a time may call the consumer functions (pop, pop_all and empty).
+	// push is wait-free (one atomic exchange) and pop is lock-free; neither
+	// allocates memory.
+	// For a type T to be compatible with mpsc_queue, T must include a data
+	// member of type mpsc_hook; a node may be in at most one mpsc_queue
+	// (per hook) at a time.
+	template <class T, mpsc_hook T::* Hook>
+	class mpsc_queue {
+		static_assert(std::atomic<mpsc_hook*>::is_always_lock_free);
+		public:
+			// The type of the elements in the queue.
+			using value_type = T;
+
+			// The pointer-to-member associated with the hook object.
+			static constexpr mpsc_hook T::* hook_ptr = Hook;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// Creates an empty queue.
+			mpsc_queue() noexcept : head_(&stub_), tail_(&stub_) {}
+
+			// Queues cannot be copied or moved (producers hold no reference
+			// to them, but may be running concurrently).
+			mpsc_queue(const mpsc_queue&) = delete;
+			mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+			// Destroys the queue. Any elements still in the queue are
+			// simply forgotten.
+			~mpsc_queue() = default;
+
+			// Appends the element x to the queue.
+			// May be called by any thread.
+			// Time complexity: Constant (wait-free).
+			void push(value_type& x) noexcept {
+				push_hook(&(x.*hook_ptr));
+			}
+
+			// Removes and returns the element at the front of the queue, or
+			// returns nullptr if the queue is empty.
+			// If a producer is in the middle of a push, the elements it
+			// is pushing (and any pushed after it) may not be visible yet,
+			// in which case nullptr is returned although the queue is not
+			// empty; they become visible once the push completes.
+			// Must be called only by the consumer.
+			// Time complexity: Constant.
+			value_type* pop() noexcept {
+				mpsc_hook* tail = tail_;
+				mpsc_hook* next = tail->next_.load(std::memory_order_acquire);
+				if(tail == &stub_){
+					if(next == nullptr){
+						return nullptr;
+					}
+					tail_ = next;
+					tail = next;
+					next = next->next_.load(std::memory_order_acquire);
+				}
+				if(next != nullptr){
+					tail_ = next;
+					return value_of(tail);
+				}
+				if(tail != head_.load(std::memory_order_acquire)){
+					return nullptr;
+				}
+				push_hook(&stub_);
+				next = tail->next_.load(std::memory_order_acquire);
+				if(next != nullptr){
+					tail_ = next;
+					return value_of(tail);
+				}
+				return nullptr;
+			}
+
+			// Removes all of the (visible) elements from the queue and
+			// appends them, in FIFO order, to the list out, using the
+			// list hook data member ListHook of T.
+			// Returns the number of elements removed.
+			// Must be called only by the consumer.
+			// Time complexity: Linear in the number of elements removed.
+			template <auto ListHook, class Stats, bool ConstantTimeSize>
+			size_type pop_all(list<T, ListHook, Stats, ConstantTimeSize>& out) noexcept {
+				size_type n = 0;
+				while(value_type* x = pop()){
+					out.push_back(*x);
+					++n;
+				}
+				return n;
+			}
+
+			// Removes all of the (visible) elements from the queue and
+			// returns them, in FIFO order, as a list using the list hook
+			// data member ListHook of T.
+			// Must be called only by the consumer.
+			// Time complexity: Linear in the number of elements removed.
+			template <auto ListHook>
+			list<T, ListHook> pop_all() noexcept {
+				list<T, ListHook> result;
+				pop_all(result);
+				return result;
+			}
+
+			// Returns true if the queue has no visible elements.
+			// Must be called only by the consumer.
+			// Time complexity: Constant.
+			bool empty() const noexcept {
+				mpsc_hook* tail = tail_;
+				return tail == &stub_ && tail->next_.load(std::memory_order_acquire) == nullptr;
+			}
+
+		private:
+			void push_hook(mpsc_hook* h) noexcept {
+				h->next_.store(nullptr, std::memory_order_relaxed);
+				mpsc_hook* prev = head_.exchange(h, std::memory_order_acq_rel);
+				prev->next_.store(h, std::memory_order_release);
+			}
+
+			static value_type* value_of(mpsc_hook* h) noexcept {
+				return ra::util::parent_from_member<value_type,mpsc_hook>(h,hook_ptr);
+			}
+
+			// The producers' end (the most recently pushed node) and the
+			// consumer's end are kept on separate cache lines, so that
+			// producers and the consumer do not contend for the same line.
+			alignas(64) std::atomic<mpsc_hook*> head_;
+			alignas(64) mpsc_hook* tail_;
+			mpsc_hook stub_;
+	};
+
+}
+#endif
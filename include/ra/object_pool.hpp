@@ -0,0 +1,338 @@
+#ifndef OBJECTPOOLHPP
+#define OBJECTPOOLHPP
+
+#include"intrusive_list.hpp"
+#include<cstddef>
+#include<memory>
+#include<mutex>
+#include<vector>
+
+namespace ra::intrusive {
+
+	// A mutex type that does nothing, for pools used by a single thread.
+	struct null_mutex {
+		void lock() noexcept {}
+		void unlock() noexcept {}
+	};
+
+	// A pool of objects of type T, allocated in chunks (slabs) of many
+	// objects at a time. The free objects are kept on intrusive lists
+	// threaded through the hook data member Hook of T (of type list_hook
+	// or auto_unlink_hook), so acquiring and releasing an object takes
+	// constant time and no allocation, and an object can go straight from
+	// a list of objects in use (via the same hook) to the pool, e.g., with
+	// list::erase_and_dispose.
+	// The free objects are grouped in batches of at least batch_size
+	// objects, each on its own list, plus one list of fewer loose objects,
+	// so that a batch can be handed over (e.g., to a cache) in constant
+	// time.
+	// The objects are default-constructed when their chunk is allocated
+	// and are destroyed only with the pool: acquire returns a released
+	// object as it was left, and the caller must reinitialize it.
+	// The pool's member functions are serialized with a Mutex; a cache
+	// (see below) lets a thread acquire and release objects without
+	// locking, exchanging them with the pool in batches. With null_mutex,
+	// the pool must be used by only one thread at a time.
+	template <class T, auto Hook, class Mutex = std::mutex>
+	class object_pool {
+		public:
+			// The type of the objects in the pool.
+			using value_type = T;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// The type of the lists of free objects (which may also be used
+			// to acquire and release objects in batches).
+			using list_type = list<T, Hook>;
+
+			// Creates an empty pool that allocates chunk_size objects at a
+			// time, and groups free objects in batches of at least
+			// batch_size objects.
+			// Time complexity: Constant.
+			explicit object_pool(size_type chunk_size = 256, size_type batch_size = 64) :
+			  chunk_size_(chunk_size ? chunk_size : 1), batch_size_(batch_size ? batch_size : 1),
+			  capacity_(0), available_(0), loose_(0) {}
+
+			// Pools cannot be copied or moved.
+			object_pool(const object_pool&) = delete;
+			object_pool& operator=(const object_pool&) = delete;
+
+			// Destroys the pool and all of its objects.
+			// Precondition: Every object acquired from the pool has been
+			// released, and no cache for the pool remains.
+			~object_pool() = default;
+
+			// Returns the minimum number of objects in a batch.
+			// Time complexity: Constant.
+			size_type batch_size() const noexcept { return batch_size_; }
+
+			// Returns the total number of objects allocated by the pool.
+			// Time complexity: Constant.
+			size_type capacity() const {
+				std::lock_guard<Mutex> lock(mutex_);
+				return capacity_;
+			}
+
+			// Returns the number of free objects held by the pool (not
+			// counting objects held by caches).
+			// Time complexity: Constant.
+			size_type available() const {
+				std::lock_guard<Mutex> lock(mutex_);
+				return available_;
+			}
+
+			// Allocates chunks until the pool holds at least n free objects.
+			// Time complexity: Linear in the number of objects allocated.
+			void reserve(size_type n) {
+				std::lock_guard<Mutex> lock(mutex_);
+				while(available_ < n){
+					grow();
+				}
+			}
+
+			// Removes an object from the pool and returns a reference to it,
+			// allocating a new chunk if the pool is empty.
+			// Time complexity: Constant (amortized, if a chunk is allocated).
+			value_type& acquire() {
+				std::lock_guard<Mutex> lock(mutex_);
+				if(loose_ == 0){
+					if(batches_.empty()){
+						grow();
+					}
+					if(loose_ == 0){
+						loose_ = take_batch(free_);
+					}
+				}
+				value_type& x = free_.back();
+				free_.pop_back();
+				--loose_;
+				--available_;
+				return x;
+			}
+
+			// Returns the object x to the pool.
+			// Precondition: x was acquired from this pool and is not in a
+			// list through Hook.
+			// Time complexity: Constant.
+			void release(value_type& x) {
+				std::lock_guard<Mutex> lock(mutex_);
+				free_.push_back(x);
+				++loose_;
+				++available_;
+				make_batch();
+			}
+
+			// Moves one batch of objects (or, if the pool holds no batch, all
+			// of the loose objects) from the pool to the end of the list out,
+			// allocating a chunk if the pool is empty. Returns the number of
+			// objects moved, which is at least one.
+			// Time complexity: Constant (amortized, if a chunk is allocated).
+			size_type acquire(list_type& out) {
+				std::lock_guard<Mutex> lock(mutex_);
+				if(batches_.empty() && loose_ == 0){
+					grow();
+				}
+				size_type n = take_batch(out);
+				available_ -= n;
+				return n;
+			}
+
+			// Moves n objects from the pool to the end of the list out
+			// (allocating chunks as needed).
+			// The pool is locked only to take whole batches; the objects
+			// taken beyond n are split off without the lock and then
+			// returned.
+			// Time complexity: Linear in n (constant in n divided by
+			// batch_size() while the pool is locked).
+			void acquire(list_type& out, size_type n) {
+				list_type taken;
+				size_type m = 0;
+				{
+					std::lock_guard<Mutex> lock(mutex_);
+					while(available_ < n){
+						grow();
+					}
+					while(m < n){
+						m += take_batch(taken);
+					}
+					available_ -= m;
+				}
+				typename list_type::iterator last = taken.begin();
+				for(size_type i=0; i<n; ++i){
+					++last;
+				}
+				out.splice(out.end(), taken, taken.begin(), last, n);
+				if(m > n){
+					release(taken, m - n);
+				}
+			}
+
+			// Returns all n objects in the list objects to the pool.
+			// Precondition: The objects were acquired from this pool, and
+			// objects has exactly n elements.
+			// Time complexity: Constant.
+			void release(list_type& objects, size_type n) {
+				std::lock_guard<Mutex> lock(mutex_);
+				free_.splice(free_.end(), objects, objects.begin(), objects.end(), n);
+				loose_ += n;
+				available_ += n;
+				make_batch();
+			}
+
+			// A per-thread cache of free objects for a pool.
+			// acquire and release on a cache do not lock the pool, except
+			// to take a batch of objects from the pool when the cache is
+			// empty, or to give a batch back when the cache holds twice the
+			// batch size; each exchange locks the pool once, for constant
+			// time.
+			// A cache must be used by only one thread at a time, and must
+			// be destroyed before its pool; its destructor returns its
+			// objects to the pool.
+			class cache {
+				public:
+					// Creates an empty cache for the pool p that gives objects
+					// back to p batch_size (by default, p.batch_size()) at a
+					// time.
+					explicit cache(object_pool& p) : cache(p, p.batch_size()) {}
+					cache(object_pool& p, size_type batch_size) :
+					  pool_(&p), batch_size_(batch_size ? batch_size : 1), count_(0) {}
+					cache(const cache&) = delete;
+					cache& operator=(const cache&) = delete;
+					~cache() {
+						pool_->release(free_, count_);
+					}
+
+					// Returns the number of free objects held by the cache.
+					size_type size() const noexcept { return count_; }
+
+					// Removes an object from the cache (refilling the cache from
+					// the pool if it is empty) and returns a reference to it.
+					// Time complexity: Constant (amortized).
+					value_type& acquire() {
+						if(count_ == 0){
+							count_ = pool_->acquire(free_);
+						}
+						value_type& x = free_.back();
+						free_.pop_back();
+						--count_;
+						return x;
+					}
+
+					// Returns the object x to the cache (and returns a batch of
+					// objects to the pool if the cache is full).
+					// Precondition: x was acquired from the cache's pool and is
+					// not in a list through Hook.
+					// Time complexity: Constant (amortized).
+					void release(value_type& x) {
+						free_.push_back(x);
+						if(++count_ >= 2 * batch_size_){
+							// Return the least recently released objects, and
+							// keep the most recent (and most likely cached) ones.
+							// The batch is split off before the pool is locked.
+							list_type batch;
+							typename list_type::iterator last = free_.begin();
+							for(size_type i=0; i<batch_size_; ++i){
+								++last;
+							}
+							batch.splice(batch.end(), free_, free_.begin(), last, batch_size_);
+							pool_->release(batch, batch_size_);
+							count_ -= batch_size_;
+						}
+					}
+
+				private:
+					object_pool* pool_;
+					size_type batch_size_;
+					size_type count_;
+					list_type free_;
+			};
+
+		private:
+			// A list of at least batch_size_ free objects.
+			struct batch {
+				list_type objects;
+				size_type size = 0;
+			};
+
+			// Moves the last batch (or, if there is none, the loose objects)
+			// to the end of out, and returns the number of objects moved
+			// (which the caller subtracts from available_ if they leave the
+			// pool).
+			// Precondition: The mutex is held, and the pool is not empty.
+			size_type take_batch(list_type& out) {
+				size_type n;
+				if(batches_.empty()){
+					n = loose_;
+					out.splice(out.end(), free_);
+					loose_ = 0;
+				}
+				else{
+					batch& b = batches_.back();
+					n = b.size;
+					out.splice(out.end(), b.objects);
+					batches_.pop_back();
+				}
+				return n;
+			}
+
+			// Turns the loose objects into a batch if there are enough of
+			// them. Every batch holds at least batch_size_ objects, so the
+			// room reserved by grow for batches is never exceeded.
+			// Precondition: The mutex is held.
+			void make_batch() noexcept {
+				if(loose_ >= batch_size_){
+					batches_.emplace_back();
+					batch& b = batches_.back();
+					b.objects.splice(b.objects.end(), free_);
+					b.size = loose_;
+					loose_ = 0;
+				}
+			}
+
+			// Allocates a chunk and adds its objects to the free lists.
+			// Precondition: The mutex is held.
+			void grow() {
+				// Make room for the chunk and for the batches that all of the
+				// objects could form first, so that linking its objects
+				// cannot be followed by a failure.
+				if(chunks_.size() == chunks_.capacity()){
+					chunks_.reserve(2 * chunks_.size() + 1);
+				}
+				batches_.reserve((capacity_ + chunk_size_) / batch_size_);
+				std::unique_ptr<value_type[]> chunk(new value_type[chunk_size_]);
+				size_type i = 0;
+				for(; chunk_size_ - i >= batch_size_; i += batch_size_){
+					batches_.emplace_back();
+					batch& b = batches_.back();
+					for(size_type j=0; j<batch_size_; ++j){
+						b.objects.push_back(chunk[i + j]);
+					}
+					b.size = batch_size_;
+				}
+				for(; i<chunk_size_; ++i){
+					free_.push_back(chunk[i]);
+					++loose_;
+				}
+				make_batch();
+				chunks_.push_back(std::move(chunk));
+				capacity_ += chunk_size_;
+				available_ += chunk_size_;
+			}
+
+			// The chunks must outlive the free lists (which may reset the
+			// hooks of the objects when they are destroyed), so they are
+			// declared first.
+			std::vector<std::unique_ptr<value_type[]>> chunks_;
+			std::vector<batch> batches_;
+			list_type free_;
+			size_type chunk_size_;
+			size_type batch_size_;
+			size_type capacity_;
+			size_type available_;
+			size_type loose_;
+			mutable Mutex mutex_;
+	};
+
+}
+#endif
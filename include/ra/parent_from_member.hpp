@@ -1,6 +1,7 @@
 #ifndef ra_util_parent_from_member_hpp
 #define ra_util_parent_from_member_hpp
 #include<cstddef>
+#include<cstring>
 
 /*
 
@@ -15,20 +16,37 @@ object from a pointer to one of its members.
 
 namespace ra::util {
 
+// This code depends on the Itanium C++ ABI (used by GCC and Clang on
+// every target except Windows), under which a pointer to a data member is
+// represented by the offset of the member. Other ABIs are rejected at
+// compile time rather than falling back to computing the offset from a
+// (null) Parent object, which is undefined behavior.
+#if !(defined(__GNUC__) || defined(__clang__)) || defined(_MSC_VER)
+#error "ra/parent_from_member.hpp requires the Itanium C++ ABI"
+#endif
+
+// Returns the offset (in bytes) of the data member designated by
+// ptr_to_member from the start of a Parent object, read from the
+// representation of ptr_to_member.
+// This is not a constant expression (the representation of a pointer to
+// member cannot be inspected in one). When ptr_to_member is a constant
+// (e.g., a template argument), optimizing compilers fold the function to
+// that constant, and parent_from_member to a single subtraction (or an
+// addressing-mode displacement).
 template <class Parent, class Member>
 inline std::ptrdiff_t offset_from_pointer_to_member(
-  const Member Parent::* ptr_to_member)
+  const Member Parent::* ptr_to_member) noexcept
 {
-	const Parent * const parent = 0;
-	const char * const member = static_cast<const char*>(
-	  static_cast<const void*>(&(parent->*ptr_to_member)));
-	return std::ptrdiff_t(member - static_cast<const char*>(
-	  static_cast<const void*>(parent)));
+	static_assert(sizeof(ptr_to_member) == sizeof(std::ptrdiff_t),
+	  "unexpected pointer-to-data-member representation");
+	std::ptrdiff_t offset;
+	std::memcpy(&offset, &ptr_to_member, sizeof(offset));
+	return offset;
 }
 
 template<class Parent, class Member>
 inline Parent *parent_from_member(Member *member,
-  const Member Parent::* ptr_to_member)
+  const Member Parent::* ptr_to_member) noexcept
 {
 	return static_cast<Parent*>(static_cast<void*>(
 	  static_cast<char*>(static_cast<void*>(member)) -
@@ -37,7 +55,7 @@ inline Parent *parent_from_member(Member *member,
 
 template<class Parent, class Member>
 inline const Parent *parent_from_member(const Member *member,
-  const Member Parent::* ptr_to_member)
+  const Member Parent::* ptr_to_member) noexcept
 {
 	return static_cast<const Parent*>(static_cast<const void*>(
 	  static_cast<const char*>(static_cast<const void*>(member)) -
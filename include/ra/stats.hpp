@@ -0,0 +1,68 @@
+#ifndef ra_util_stats_hpp
+#define ra_util_stats_hpp
+#include<cstdint>
+#include<type_traits>
+
+/*
+
+Operation statistics policies for the containers in this project.
+
+A container that accepts a Stats template parameter counts what it does
+only if Stats::enabled is true. With the default policy (no_stats) the
+counters are an empty member that occupies no storage, and every counting
+statement is discarded at compile time.
+
+*/
+
+namespace ra::util {
+
+	// The counters collected by ra::container::sv_set.
+	struct sv_set_stats {
+		// Number of calls made to the comparison object.
+		std::uint64_t comparisons = 0;
+		// Number of element copies (constructions and assignments).
+		std::uint64_t copies = 0;
+		// Number of element moves (constructions and assignments).
+		std::uint64_t moves = 0;
+		// Number of times element storage was (re)allocated.
+		std::uint64_t reallocations = 0;
+		// Total number of bytes of element storage allocated.
+		std::uint64_t bytes_allocated = 0;
+		// Total number of bytes of elements copied or moved into
+		// newly allocated storage.
+		std::uint64_t bytes_copied = 0;
+		// Largest size() the container has reached.
+		std::uint64_t high_water_size = 0;
+	};
+
+	// The counters collected by ra::intrusive::list.
+	struct list_stats {
+		// Number of elements inserted.
+		std::uint64_t inserts = 0;
+		// Number of elements erased.
+		std::uint64_t erases = 0;
+		// Number of traversals started (i.e., calls to begin()).
+		std::uint64_t iterations = 0;
+		// Largest size() the list has reached.
+		std::uint64_t high_water_size = 0;
+	};
+
+	// Statistics policy that collects nothing (the default).
+	struct no_stats {
+		static constexpr bool enabled = false;
+	};
+
+	// Statistics policy that collects all counters.
+	struct count_stats {
+		static constexpr bool enabled = true;
+	};
+
+	// The type used by a container to hold its counters: Counters if
+	// the policy Stats is enabled and an empty type otherwise.
+	struct empty_stats {};
+	template <class Stats, class Counters>
+	using stats_storage_t = std::conditional_t<Stats::enabled, Counters, empty_stats>;
+
+}
+
+#endif
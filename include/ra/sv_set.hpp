@@ -6,13 +6,17 @@
 #include<memory>
 #include<utility>
 #include<algorithm>
+#include<type_traits>
+#include"stats.hpp"
 
 
 namespace ra::container {
 
 	// A class representing a set of unique elements (which uses
 	// a sorted array).
-	template <class Key, class Compare = std::less<Key>>
+	// The Stats parameter selects whether operation counters are
+	// collected (see ra/stats.hpp); by default, nothing is collected.
+	template <class Key, class Compare = std::less<Key>, class Stats = ra::util::no_stats>
 	class sv_set {
 		public:
 			// A dummy type used to indicate that elements in a range
@@ -42,6 +46,11 @@ namespace ra::container {
 			// This type must support all of the functionality associated
 			// with a random-access iterator.
 			using const_iterator = const Key*;
+
+			// The statistics policy and the type of the counters it
+			// collects.
+			using stats_policy = Stats;
+			using stats_type = ra::util::sv_set_stats;
 	
 			// Creates an empty set (i.e., a set containing no elements)
 			// with a capacity of zero (i.e., no allocated storage for
@@ -73,7 +82,8 @@ namespace ra::container {
 			// Move construction.
 			// Creates a new set by moving from the specified set other.
 			// After construction, the source set (i.e., other) is
-			// guaranteed to be empty.
+			// guaranteed to be empty. The statistics move with the storage
+			// (i.e., other's counters are cleared).
 			// Time complexity: Constant.
 			sv_set(sv_set&& other) noexcept(std::is_nothrow_move_constructible<key_compare>::value) : compare_obj_(key_compare()) {
 				begin_ = other.begin_;
@@ -82,13 +92,14 @@ namespace ra::container {
 				other.end_ = nullptr;
 				finish_ = other.finish_;
 				other.finish_ = nullptr;
-
+				take_stats(other);
 			}
 
 			// Move assignment.
 			// Assigns the value of the specified set other to *this
 			// via a move operation. After the move operation, the source set (i.e., other)
-			// is guaranteed to be empty. Time complexity: Linear in size().
+			// is guaranteed to be empty. As for move construction, the
+			// statistics move with the storage. Time complexity: Linear in size().
 			// Precondition: The objects *this and other are distinct.
 			sv_set& operator=(sv_set&& other) noexcept(std::is_nothrow_move_assignable<key_compare>::value){
 				if(this != &other){
@@ -102,6 +113,7 @@ namespace ra::container {
 					other.begin_ = nullptr;
 					other.end_ = nullptr;
 					other.finish_ = nullptr;
+					take_stats(other);
 				}
 				return *this;
 			}
@@ -119,6 +131,9 @@ namespace ra::container {
 					::operator delete(begin_);
 					throw;
 				}
+				count_allocation(other.size(), 0);
+				count_copies(other.size());
+				count_size();
 			}
 
 			// Copy assignment.
@@ -129,6 +144,8 @@ namespace ra::container {
 					clear();
 					if(other.size() > capacity()) {reserve(other.size());}
 					finish_ = std::uninitialized_copy(other.begin_, other.finish_, begin_);
+					count_copies(other.size());
+					count_size();
 				}
 				return *this;
 			}
@@ -152,7 +169,7 @@ namespace ra::container {
 				       	return begin_;
 				}
 				else{
-					return end_;
+					return finish_;
 				}
 			}
 			iterator begin() noexcept {
@@ -160,14 +177,14 @@ namespace ra::container {
 					return begin_;
 				}
 				else{
-					return end_;
+					return finish_;
 				}
 			}
 
 			// Returns an iterator referring to the fictitious
 			// one-past-the-end element for the set. Time complexity: Constant.
-			const_iterator end() const noexcept { return end_; }
-			iterator end() noexcept { return end_; }
+			const_iterator end() const noexcept { return finish_; }
+			iterator end() noexcept { return finish_; }
 
 			// Returns the number of elements in the set (i.e., the size of the set).
 			// Time complexity: Constant.
@@ -194,16 +211,18 @@ namespace ra::container {
 					size_type oldSize = size();
 					try{
 						if(begin_!=nullptr && end_!=nullptr && finish_!=nullptr){
-							std::uninitialized_copy(begin_,finish_,newBegin);
+							relocate(newBegin);
 						}
 					} catch(...){
 						::operator delete(newBegin);
 						throw;
 					}
+					std::destroy(begin_,finish_);
 					::operator delete(begin_);
 					begin_ = newBegin;
 					end_ = begin_ + n;
 					finish_ = begin_ + oldSize;
+					count_allocation(n, oldSize);
 					
 				}
 			}
@@ -221,16 +240,18 @@ namespace ra::container {
 					size_type oldSize = size();
 					try{
 						if(begin_!=nullptr && end_!=nullptr && finish_!=nullptr){
-							std::uninitialized_copy(begin_,finish_,newBegin);
+							relocate(newBegin);
 						}
 					} catch(...){
 						::operator delete(newBegin);
 						throw;
 					}
+					std::destroy(begin_,finish_);
 					::operator delete(begin_);
 					begin_ = newBegin;
 					finish_ = begin_+oldSize;
 					end_ = begin_ + size();
+					count_allocation(oldSize, oldSize);
 				}
 			}
 
@@ -249,24 +270,22 @@ namespace ra::container {
 			// keys than x (if size() < capacity()) or size()
 			// (if size() == capacity()).
 			std::pair<iterator, bool> insert(const key_type& x){
-				key_type temp;
-				key_type hold;
 				bool search_done = false;
 				bool found_x = false;
 				iterator s_begin = begin_;
 				iterator s_finish = finish_;
-				iterator s_mid;
+				iterator s_mid = begin_;
 				if(begin_!=finish_){
 					while(search_done == false){
 						s_mid = ((s_finish - s_begin)/2) + s_begin;
-						if(!compare_obj_(x,*s_mid) && !compare_obj_(*s_mid,x)){
+						if(!less(x,*s_mid) && !less(*s_mid,x)){
 							search_done = true;
 							found_x = true;
 						}
 						else if(s_mid==s_begin){
 							search_done = true;
 						}
-						else if(compare_obj_(x,*s_mid)){
+						else if(less(x,*s_mid)){
 							s_finish = s_mid;
 						}
 						else{
@@ -280,38 +299,29 @@ namespace ra::container {
 				else{
 					if(capacity()==size()){
 						size_type s_mid_pos = s_mid - begin_;
-						reserve(size()+size_type(1));
+						reserve(size() ? 2*size() : size_type(1));
 						s_mid = begin_ + s_mid_pos;
 					}
 					if(begin_!=finish_){
-						if(compare_obj_(x,*begin_)){ s_mid = begin_; }
+						if(less(x,*begin_)){ s_mid = begin_; }
+						iterator pos = less(x,*s_mid) ? s_mid : s_mid+size_type(1);
 						finish_ = new (static_cast<void*>(finish_)) key_type;
 						finish_ = finish_ + size_type(1);
-						if(compare_obj_(x,*s_mid)){
-							hold = *s_mid;
-							*s_mid = x;
-							for(iterator i=(s_mid+size_type(1)); i<finish_; ++i){
-								temp = *i;
-								*i = hold;
-								hold = temp;
-							}
-							return std::pair<iterator,bool>(s_mid,true);
-						}
-						else{
-							hold = *(s_mid+size_type(1));
-							*(s_mid+size_type(1)) = x;
-							for(iterator i=(s_mid+size_type(2)); i<finish_; ++i){
-								temp = *i;
-								*i = hold;
-								hold = temp;
-							}
-							return std::pair<iterator,bool>(s_mid+size_type(1),true);
-						}
+						// Shift the larger elements up by one (by moving them)
+						// and copy x into the gap.
+						std::move_backward(pos, finish_-size_type(1), finish_);
+						count_moves((finish_-size_type(1)) - pos);
+						*pos = x;
+						count_copies(1);
+						count_size();
+						return std::pair<iterator,bool>(pos,true);
 					}
 					else{
 						finish_ = new (static_cast<void*>(finish_)) key_type;
 						finish_ = finish_ + size_type(1);
 						*begin_ = x;
+						count_copies(1);
+						count_size();
 						return std::pair<iterator,bool>(begin_,true);
 					}
 				}
@@ -326,9 +336,8 @@ namespace ra::container {
 			iterator erase(const_iterator pos){
 				if(pos < (finish_-1)){
 					size_type pos_s = pos - begin_;
-					for(size_type i=pos_s; i<(size()-1); ++i){
-						*(begin_+i) = *(begin_+i+1);
-					}
+					std::move(begin_+pos_s+1, finish_, begin_+pos_s);
+					count_moves(size()-1-pos_s);
 					(finish_-1)->~Key();
 					finish_ = finish_ - 1;
 					return (begin_ + pos_s);
@@ -344,7 +353,7 @@ namespace ra::container {
 			}
 
 			// Swaps the contents of the container with the contents of the
-			// container x.
+			// container x (including the statistics).
 			// Time complexity: Constant.
 			void swap(sv_set& x) noexcept(std::is_nothrow_swappable_v<key_compare>){
 				iterator temp_begin = begin_;
@@ -356,6 +365,9 @@ namespace ra::container {
 				x.begin_ = temp_begin;
 				x.finish_ = temp_finish;
 				x.end_ = temp_end;
+				if constexpr(stats_policy::enabled){
+					std::swap(stats_, x.stats_);
+				}
 			}
 
 			// Erases any elements in the container, yielding an empty
@@ -384,14 +396,14 @@ namespace ra::container {
 				if(begin_!=finish_){
 					while(search_done == false){
 						s_mid = ((s_finish - s_begin)/2) + s_begin;
-						if(!compare_obj_(k,*s_mid) && !compare_obj_(*s_mid,k)){
+						if(!less(k,*s_mid) && !less(*s_mid,k)){
 							search_done = true;
 							found_k = true;
 						}
 						else if(s_mid==s_begin){
 							search_done = true;
 						}
-						else if(compare_obj_(k,*s_mid)){
+						else if(less(k,*s_mid)){
 							s_finish = s_mid; 
 						}
 						else{
@@ -416,14 +428,14 @@ namespace ra::container {
 				if(begin_!=finish_){
 					while(search_done == false){
 						s_mid = ((s_finish - s_begin)/2) + s_begin;
-						if(!compare_obj_(k,*s_mid) && !compare_obj_(*s_mid,k)){
+						if(!less(k,*s_mid) && !less(*s_mid,k)){
 							search_done = true;
 							found_k = true;
 						}
 						else if(s_mid==s_begin){
 							search_done = true;
 						}
-						else if(compare_obj_(k,*s_mid)){
+						else if(less(k,*s_mid)){
 							s_finish = s_mid; 
 						}
 						else{
@@ -439,11 +451,108 @@ namespace ra::container {
 				}
 			}
 
+			// Returns the operation counters collected so far.
+			// If the statistics policy is disabled, all counters are zero.
+			// Time complexity: Constant.
+			stats_type stats() const noexcept {
+				if constexpr(stats_policy::enabled){
+					return stats_;
+				}
+				else{
+					return stats_type();
+				}
+			}
+
+			// Resets all operation counters to zero.
+			// Time complexity: Constant.
+			void reset_stats() noexcept {
+				if constexpr(stats_policy::enabled){
+					stats_ = stats_type();
+				}
+			}
+
 		private:
+			// Compares two keys with the comparison object, counting
+			// the comparison if statistics are enabled.
+			bool less(const key_type& a, const key_type& b) const {
+				if constexpr(stats_policy::enabled){
+					++stats_.comparisons;
+				}
+				return compare_obj_(a,b);
+			}
+
+			// Record n element copies.
+			// Takes the counters of other, clearing them in other.
+			void take_stats(sv_set& other) noexcept {
+				if constexpr(stats_policy::enabled){
+					stats_ = other.stats_;
+					other.stats_ = stats_type();
+				}
+			}
+
+			void count_copies(size_type n) const noexcept {
+				if constexpr(stats_policy::enabled){
+					stats_.copies += n;
+				}
+			}
+
+			// Record n element moves.
+			void count_moves(size_type n) const noexcept {
+				if constexpr(stats_policy::enabled){
+					stats_.moves += n;
+				}
+			}
+
+			// Whether relocate moves (rather than copies) the elements:
+			// only if that cannot throw, so that a failed relocation
+			// leaves the elements intact.
+			static constexpr bool relocates_by_move = std::is_nothrow_move_constructible_v<key_type> ||
+			  !std::is_copy_constructible_v<key_type>;
+
+			// Constructs the elements in the (uninitialized) storage
+			// starting at dest from the elements of the container, by
+			// moving or copying them (see relocates_by_move).
+			void relocate(key_type* dest){
+				if constexpr(relocates_by_move){
+					std::uninitialized_move(begin_, finish_, dest);
+				}
+				else{
+					std::uninitialized_copy(begin_, finish_, dest);
+				}
+			}
+
+			// Record an allocation of storage for n elements into which
+			// relocated elements (moved or copied; see relocate) were
+			// transferred.
+			void count_allocation(size_type n, size_type relocated) const noexcept {
+				if constexpr(stats_policy::enabled){
+					++stats_.reallocations;
+					stats_.bytes_allocated += n * sizeof(key_type);
+					if constexpr(relocates_by_move){
+						stats_.moves += relocated;
+					}
+					else{
+						stats_.copies += relocated;
+					}
+					stats_.bytes_copied += relocated * sizeof(key_type);
+				}
+			}
+
+			// Record the current size as the high-water size if it is
+			// the largest seen so far.
+			void count_size() const noexcept {
+				if constexpr(stats_policy::enabled){
+					if(size() > stats_.high_water_size){
+						stats_.high_water_size = size();
+					}
+				}
+			}
+
 			key_type* begin_;
 			key_type* end_;
 			key_type* finish_;
 			key_compare compare_obj_;
+			[[no_unique_address]] mutable ra::util::stats_storage_t<stats_policy, stats_type> stats_;
 
 
 	};
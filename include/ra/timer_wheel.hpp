@@ -0,0 +1,239 @@
+#ifndef TIMERWHEELHPP
+#define TIMERWHEELHPP
+
+#include"intrusive_list.hpp"
+#include<cstddef>
+#include<cstdint>
+
+namespace ra::intrusive {
+
+	// Per-timer management information for timer_wheel: a list hook that
+	// also records the time at which the timer expires.
+	// Like auto_unlink_hook, the hook removes its timer from the wheel when
+	// it is destroyed (i.e., destroying a timer cancels it).
+	class timer_hook : public auto_unlink_hook {
+		public:
+			timer_hook() noexcept : expiry_(0) {}
+			timer_hook(const timer_hook&) noexcept : auto_unlink_hook(), expiry_(0) {}
+			timer_hook& operator=(const timer_hook&) noexcept { return *this; }
+			~timer_hook() = default;
+
+			// Returns the time (in ticks) at which the timer expires.
+			// Precondition: The timer is scheduled.
+			std::uint64_t expiry() const noexcept { return expiry_; }
+
+			template<class T, auto Hook, std::size_t Levels>
+			friend class timer_wheel;
+		private:
+			std::uint64_t expiry_;
+	};
+
+	// Hierarchical hashed timer wheel (Varghese and Lauck) of intrusive
+	// timers: objects of type T with a data member Hook of type timer_hook.
+	// Time is measured in ticks (of a duration chosen by the user). The
+	// wheel has Levels levels of 64 buckets each; a bucket at level k spans
+	// 64^k ticks, so the levels cover 64^Levels ticks ahead of the current
+	// time, and timers further ahead wait on an overflow list. Each bucket
+	// is an intrusive list, and each level has a bitmap of its nonempty
+	// buckets, so that advancing the time skips empty buckets.
+	// Scheduling, rescheduling and cancelling a timer take constant time
+	// and never allocate. As time advances, the timers in a bucket of a
+	// higher level are moved (cascaded) to lower levels, and the timers in
+	// the current bucket of the lowest level are fired in bulk.
+	template <class T, auto Hook, std::size_t Levels = 4>
+	class timer_wheel {
+		static_assert(Levels >= 1 && 6 * Levels < 64, "invalid number of timer wheel levels");
+		public:
+			// The type of the timers.
+			using value_type = T;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// The type used to represent times (in ticks).
+			using time_type = std::uint64_t;
+
+			// The number of buckets per level.
+			static constexpr size_type slots = 64;
+
+			// The number of ticks ahead of the current time covered by the
+			// levels of the wheel (i.e., 64^Levels).
+			static constexpr time_type range = time_type(1) << (6 * Levels);
+
+			// Creates a wheel with no timers whose current time is now.
+			// Time complexity: Constant.
+			explicit timer_wheel(time_type now = 0) noexcept : now_(now), occupied_() {}
+
+			// Wheels cannot be copied or moved.
+			timer_wheel(const timer_wheel&) = delete;
+			timer_wheel& operator=(const timer_wheel&) = delete;
+
+			// Destroys the wheel. Any timers still scheduled are cancelled.
+			~timer_wheel() = default;
+
+			// Returns the current time.
+			// Time complexity: Constant.
+			time_type now() const noexcept { return now_; }
+
+			// Schedules the timer t to expire at the time expiry; if t is
+			// already scheduled, it is rescheduled. Since advance(now())
+			// fires nothing, the expiry time of a timer scheduled at or
+			// before the current time is clamped to now()+1: the timer fires
+			// on the first call to advance past now().
+			// Time complexity: Constant.
+			void schedule(value_type& t, time_type expiry) noexcept {
+				timer_hook& h = t.*Hook;
+				h.unlink();
+				h.expiry_ = expiry > now_ ? expiry : now_ + 1;
+				insert(t);
+			}
+
+			// Cancels the timer t, if it is scheduled.
+			// Time complexity: Constant.
+			static void cancel(value_type& t) noexcept { (t.*Hook).unlink(); }
+
+			// Returns true if the timer t is scheduled.
+			// Time complexity: Constant.
+			static bool is_scheduled(const value_type& t) noexcept { return (t.*Hook).is_linked(); }
+
+			// Advances the current time to now, firing every timer that
+			// expires at or before now: each such timer t is unscheduled and
+			// then passed to callback(t), which may reschedule, cancel or
+			// destroy any timer. Timers fire in order of their expiry times
+			// (and in no particular order for equal times).
+			// Returns the number of timers fired.
+			// Precondition: now is not less than now().
+			// Time complexity: Linear in the number of timers fired and
+			// cascaded, plus the number of levels times the number of
+			// nonempty buckets passed.
+			template <class Callback>
+			size_type advance(time_type now, Callback callback) {
+				size_type fired = 0;
+				while(now_ < now){
+					time_type next = next_event();
+					if(next > now){
+						now_ = now;
+						break;
+					}
+					now_ = next;
+					if(now_ % range == 0){
+						cascade(overflow_);
+					}
+					for(size_type k=Levels-1; k>0; --k){
+						if(now_ % (time_type(1) << (6 * k)) == 0){
+							cascade_slot(k, slot_of(now_, k));
+						}
+					}
+					fired += fire(slot_of(now_, 0), callback);
+				}
+				return fired;
+			}
+
+			// Returns true if no timers are scheduled.
+			// Time complexity: Linear in the number of nonempty buckets.
+			bool empty() const noexcept {
+				for(size_type k=0; k<Levels; ++k){
+					for(std::uint64_t bits = occupied_[k]; bits; bits &= bits - 1){
+						if(!buckets_[k][__builtin_ctzll(bits)].empty()){
+							return false;
+						}
+					}
+				}
+				return overflow_.empty();
+			}
+
+		private:
+			// The type of a bucket. Timers unlink themselves, so buckets do
+			// not keep sizes (and the occupancy bitmaps may show a bucket as
+			// nonempty after its last timer was cancelled).
+			using list_type = list<T, Hook>;
+
+			// Returns the index at level k of the bucket containing time t.
+			static size_type slot_of(time_type t, size_type k) noexcept {
+				return size_type(t >> (6 * k)) % slots;
+			}
+
+			// Adds the timer t to the bucket for its expiry time: the level
+			// is given by the highest 6-bit group in which the expiry time
+			// differs from the current time. (A timer cascaded at its expiry
+			// time goes to the current bucket of level 0, which is fired
+			// after cascading.)
+			// Precondition: The expiry time is not before now_.
+			void insert(value_type& t) noexcept {
+				time_type expiry = (t.*Hook).expiry_;
+				size_type k = expiry == now_ ? 0 : size_type(63 - __builtin_clzll(expiry ^ now_)) / 6;
+				if(k >= Levels){
+					overflow_.push_back(t);
+					return;
+				}
+				size_type s = slot_of(expiry, k);
+				buckets_[k][s].push_back(t);
+				occupied_[k] |= std::uint64_t(1) << s;
+			}
+
+			// Returns the earliest time after now_ at which a bucket must be
+			// cascaded or fired (or the maximum time if there is none).
+			time_type next_event() const noexcept {
+				time_type next = ~time_type(0);
+				for(size_type k=0; k<Levels; ++k){
+					// The buckets at level k after the current one.
+					size_type s = slot_of(now_, k);
+					std::uint64_t later = s == slots - 1 ? 0 : occupied_[k] & (~std::uint64_t(0) << (s + 1));
+					if(later){
+						time_type cycle = now_ >> (6 * (k + 1)) << (6 * (k + 1));
+						time_type t = cycle + (time_type(__builtin_ctzll(later)) << (6 * k));
+						next = t < next ? t : next;
+					}
+				}
+				if(!overflow_.empty()){
+					time_type t = (now_ / range + 1) * range;
+					next = t < next ? t : next;
+				}
+				return next;
+			}
+
+			// Moves the timers in the bucket at index s of level k to the
+			// buckets for their expiry times (at lower levels).
+			void cascade_slot(size_type k, size_type s) noexcept {
+				if(occupied_[k] & (std::uint64_t(1) << s)){
+					occupied_[k] &= ~(std::uint64_t(1) << s);
+					cascade(buckets_[k][s]);
+				}
+			}
+			void cascade(list_type& bucket) noexcept {
+				list_type pending;
+				pending.splice(pending.end(), bucket);
+				while(!pending.empty()){
+					value_type& t = pending.front();
+					pending.pop_front();
+					insert(t);
+				}
+			}
+
+			// Fires the timers in the bucket at index s of level 0.
+			template <class Callback>
+			size_type fire(size_type s, Callback& callback) {
+				if(!(occupied_[0] & (std::uint64_t(1) << s))){
+					return 0;
+				}
+				occupied_[0] &= ~(std::uint64_t(1) << s);
+				list_type expired;
+				expired.splice(expired.end(), buckets_[0][s]);
+				size_type n = 0;
+				while(!expired.empty()){
+					value_type& t = expired.front();
+					expired.pop_front();
+					callback(t);
+					++n;
+				}
+				return n;
+			}
+
+			time_type now_;
+			std::uint64_t occupied_[Levels];
+			list_type buckets_[Levels][slots];
+			list_type overflow_;
+	};
+
+}
+#endif
@@ -0,0 +1,354 @@
+#ifndef UNORDEREDSETHPP
+#define UNORDEREDSETHPP
+
+#include"fibonacci_hash.hpp"
+#include"intrusive_list.hpp"
+#include<cstddef>
+#include<functional>
+#include<iterator>
+#include<type_traits>
+#include<utility>
+
+namespace ra::intrusive {
+
+	// An intrusive hash set: an index over objects of type T that are
+	// owned (and allocated) by the caller. The elements are chained in
+	// buckets, each of which is a list (that does not keep its size)
+	// threaded through the hook Hook of T, as for list (i.e., a pointer to
+	// a list_hook data member of T, or base_hook). The bucket array is
+	// also provided by the caller, so that no operation ever allocates
+	// memory; rehash moves the elements to another bucket array.
+	// The elements are hashed with Hash and compared with KeyEqual. If
+	// both have a member type is_transparent, elements can be looked up by
+	// any key type that they accept (heterogeneous lookup); KeyEqual is
+	// called with an element as its first argument and the key as its
+	// second.
+	// The number of buckets must be a power of two (at least two), and
+	// the bucket of an element is chosen from its hash value as described
+	// in ra/fibonacci_hash.hpp.
+	// Elements must be erased from the set before they are destroyed, and
+	// the set must be destroyed (or cleared) before its bucket array.
+	template <class T, auto Hook, class Hash = std::hash<T>, class KeyEqual = std::equal_to<T>>
+	class unordered_set {
+		public:
+			// The type of the elements in the set.
+			using value_type = T;
+
+			// The types of the hash function and equality predicate.
+			using hasher = Hash;
+			using key_equal = KeyEqual;
+
+			// The type of a mutating reference to an element.
+			using reference = T&;
+
+			// The type of a non-mutating reference to an element.
+			using const_reference = const T&;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// The type of a bucket. The caller provides arrays of buckets,
+			// which must be empty when they are passed to the set.
+			using bucket_type = list<T, Hook, ra::util::no_stats, false>;
+			static_assert(!list_hook_traits<T, Hook>::hook_type::auto_unlink,
+			  "the elements of an unordered_set cannot have auto_unlink_hook hooks (the set keeps its size)");
+
+		private:
+			// The iterator classes: a position in a bucket, and the
+			// range of buckets left to visit.
+			template <bool Const>
+			class basic_iterator {
+				public:
+					using value_type = T;
+					using iterator_category = std::forward_iterator_tag;
+					using difference_type = std::ptrdiff_t;
+					using pointer = std::conditional_t<Const, const T*, T*>;
+					using reference = std::conditional_t<Const, const T&, T&>;
+					basic_iterator() noexcept : bucket_(nullptr), last_(nullptr), pos_() {}
+					template <bool C = Const, class = std::enable_if_t<C>>
+					basic_iterator(const basic_iterator<false>& other) noexcept :
+					  bucket_(other.bucket_), last_(other.last_), pos_(other.pos_) {}
+					bool operator==(const basic_iterator& other) const noexcept {
+						return pos_ == other.pos_;
+					}
+					bool operator!=(const basic_iterator& other) const noexcept {
+						return pos_ != other.pos_;
+					}
+					reference operator*() const noexcept {
+						return *pos_;
+					}
+					pointer operator->() const noexcept {
+						return &*pos_;
+					}
+					basic_iterator& operator++() noexcept {
+						++pos_;
+						skip_empty();
+						return *this;
+					}
+					basic_iterator operator++(int) noexcept {
+						basic_iterator oldIter(*this);
+						++*this;
+						return oldIter;
+					}
+				private:
+					using bucket_pointer = std::conditional_t<Const, const bucket_type*, bucket_type*>;
+					using list_iterator = std::conditional_t<Const,
+					  typename bucket_type::const_iterator, typename bucket_type::iterator>;
+					basic_iterator(bucket_pointer bucket, bucket_pointer last, list_iterator pos) noexcept :
+					  bucket_(bucket), last_(last), pos_(pos) {}
+					// Moves past the end of empty buckets; the end iterator
+					// has a null position.
+					void skip_empty() noexcept {
+						while(pos_ == bucket_->end()){
+							if(++bucket_ == last_){
+								pos_ = list_iterator();
+								return;
+							}
+							pos_ = bucket_->begin();
+						}
+					}
+					bucket_pointer bucket_;
+					bucket_pointer last_;
+					list_iterator pos_;
+					friend class unordered_set;
+					friend class basic_iterator<!Const>;
+			};
+
+		public:
+			// The mutating (forward) iterator type for the set. The
+			// elements must not be modified in a way that changes their
+			// hash value.
+			using iterator = basic_iterator<false>;
+
+			// The non-mutating (forward) iterator type for the set.
+			using const_iterator = basic_iterator<true>;
+
+			// Creates an empty set using the bucket_count (empty) buckets
+			// starting at buckets.
+			// Precondition: bucket_count is a power of two (at least two).
+			// Time complexity: Constant.
+			unordered_set(bucket_type* buckets, size_type bucket_count,
+			  const hasher& hash = hasher(), const key_equal& equal = key_equal()) :
+			  buckets_(buckets), bucket_count_(bucket_count), shift_(ra::util::fibonacci_shift(bucket_count)),
+			  size_(0), hash_(hash), equal_(equal) {}
+
+			// Sets cannot be copied or moved (their elements can be in only
+			// one set, and the set does not own its buckets).
+			unordered_set(const unordered_set&) = delete;
+			unordered_set& operator=(const unordered_set&) = delete;
+
+			// Destroys the set. The elements are unlinked.
+			// Time complexity: Linear in size() plus bucket_count().
+			~unordered_set() {
+				clear();
+			}
+
+			// Returns the number of elements in the set.
+			// Time complexity: Constant.
+			size_type size() const noexcept { return size_; }
+
+			// Returns true if the set has no elements.
+			// Time complexity: Constant.
+			bool empty() const noexcept { return size_ == 0; }
+
+			// Returns the number of buckets.
+			// Time complexity: Constant.
+			size_type bucket_count() const noexcept { return bucket_count_; }
+
+			// Returns the bucket array.
+			// Time complexity: Constant.
+			bucket_type* buckets() const noexcept { return buckets_; }
+
+			// Returns the average number of elements per bucket.
+			// Time complexity: Constant.
+			float load_factor() const noexcept { return float(size_) / float(bucket_count_); }
+
+			// Returns the index of the bucket for elements equal to k.
+			// Time complexity: Constant.
+			template <class K>
+			size_type bucket(const K& k) const {
+				return ra::util::fibonacci_bucket(hash_(k), shift_);
+			}
+
+			// Returns an iterator referring to the first element in the set
+			// if the set is not empty and end() otherwise.
+			// Time complexity: Linear in the number of leading empty buckets.
+			iterator begin() noexcept {
+				iterator i(buckets_, buckets_ + bucket_count_, buckets_[0].begin());
+				i.skip_empty();
+				return i;
+			}
+			const_iterator begin() const noexcept {
+				const bucket_type* first = buckets_;
+				const_iterator i(first, first + bucket_count_, first->begin());
+				i.skip_empty();
+				return i;
+			}
+
+			// Returns an iterator referring to the fictitious one-past-the-end
+			// element.
+			// Time complexity: Constant.
+			iterator end() noexcept { return iterator(); }
+			const_iterator end() const noexcept { return const_iterator(); }
+
+			// Returns an iterator referring to the element x, which must be
+			// in the set.
+			// Time complexity: Constant.
+			iterator iterator_to(reference x) {
+				bucket_type* b = buckets_ + bucket(x);
+				return iterator(b, buckets_ + bucket_count_, bucket_type::s_iterator_to(x));
+			}
+			const_iterator iterator_to(const_reference x) const {
+				const bucket_type* b = buckets_ + bucket(x);
+				return const_iterator(b, buckets_ + bucket_count_, bucket_type::s_iterator_to(x));
+			}
+
+			// Inserts the element x, unless the set already has an element
+			// equal to x. Returns an iterator referring to the element equal
+			// to x and whether x was inserted.
+			// Precondition: x is not in a set or list through Hook.
+			// Time complexity: Constant on average.
+			std::pair<iterator, bool> insert(reference x) {
+				bucket_type* b = buckets_ + bucket(x);
+				typename bucket_type::iterator pos = find_in(*b, x);
+				if(pos != b->end()){
+					return std::pair<iterator, bool>(iterator(b, buckets_ + bucket_count_, pos), false);
+				}
+				++size_;
+				return std::pair<iterator, bool>(iterator(b, buckets_ + bucket_count_, b->insert(b->begin(), x)), true);
+			}
+
+			// Returns an iterator referring to the element equal to k, or
+			// end() if there is none. Keys of other types than T are
+			// accepted if Hash and KeyEqual are transparent.
+			// Time complexity: Constant on average.
+			iterator find(const_reference k) { return find_impl(*this, k); }
+			const_iterator find(const_reference k) const { return find_impl(*this, k); }
+			template <class K, class H = Hash, class E = KeyEqual,
+			  class = typename H::is_transparent, class = typename E::is_transparent>
+			iterator find(const K& k) { return find_impl(*this, k); }
+			template <class K, class H = Hash, class E = KeyEqual,
+			  class = typename H::is_transparent, class = typename E::is_transparent>
+			const_iterator find(const K& k) const { return find_impl(*this, k); }
+
+			// Returns true if the set has an element equal to k.
+			// Time complexity: Constant on average.
+			bool contains(const_reference k) const { return find(k) != end(); }
+			template <class K, class H = Hash, class E = KeyEqual,
+			  class = typename H::is_transparent, class = typename E::is_transparent>
+			bool contains(const K& k) const { return find(k) != end(); }
+
+			// Erases the element x from the set.
+			// Precondition: x is in the set.
+			// Time complexity: Constant.
+			void erase(reference x) {
+				bucket_type& b = buckets_[bucket(x)];
+				b.erase(bucket_type::s_iterator_to(x));
+				--size_;
+			}
+
+			// Erases the element referred to by pos. Returns an iterator
+			// referring to the element following the erased element.
+			// Time complexity: Constant on average.
+			iterator erase(iterator pos) {
+				iterator next = pos;
+				++next;
+				pos.bucket_->erase(pos.pos_);
+				--size_;
+				return next;
+			}
+
+			// Erases the element equal to k, if there is one, and passes it
+			// to disposer (e.g., to return it to a pool). Returns the number
+			// of elements erased.
+			// Time complexity: Constant on average (plus the disposer).
+			template <class K, class Disposer>
+			size_type erase_and_dispose(const K& k, Disposer disposer) {
+				bucket_type& b = buckets_[bucket(k)];
+				typename bucket_type::iterator pos = find_in(b, k);
+				if(pos == b.end()){
+					return 0;
+				}
+				b.erase_and_dispose(pos, disposer);
+				--size_;
+				return 1;
+			}
+
+			// Erases all of the elements, resetting their hooks.
+			// Time complexity: Linear in size() plus bucket_count().
+			void clear() {
+				clear_and_dispose([](value_type*) {});
+			}
+
+			// Erases all of the elements and passes each of them to
+			// disposer.
+			// Time complexity: Linear in size() plus bucket_count().
+			template <class Disposer>
+			void clear_and_dispose(Disposer disposer) {
+				if(size_){
+					for(size_type i=0; i<bucket_count_; ++i){
+						buckets_[i].clear_and_dispose(disposer);
+					}
+					size_ = 0;
+				}
+			}
+
+			// Moves all of the elements to the bucket_count (empty) buckets
+			// starting at buckets, which the set uses from then on. The
+			// old buckets are left empty, and may be released or reused by
+			// the caller.
+			// Precondition: bucket_count is a power of two (at least two).
+			// Time complexity: Linear in size() plus the number of old
+			// buckets.
+			void rehash(bucket_type* buckets, size_type bucket_count) {
+				bucket_type* old_buckets = buckets_;
+				size_type old_count = bucket_count_;
+				buckets_ = buckets;
+				bucket_count_ = bucket_count;
+				shift_ = ra::util::fibonacci_shift(bucket_count);
+				for(size_type i=0; i<old_count; ++i){
+					bucket_type& old = old_buckets[i];
+					while(!old.empty()){
+						reference x = old.front();
+						bucket_type& b = buckets_[bucket(x)];
+						b.splice(b.begin(), old, old.begin());
+					}
+				}
+			}
+
+		private:
+			// Returns an iterator referring to the element in b equal to k,
+			// or b.end() if there is none.
+			template <class Bucket, class K>
+			auto find_in(Bucket& b, const K& k) const -> decltype(b.begin()) {
+				auto last = b.end();
+				for(auto i = b.begin(); i != last; ++i){
+					if(equal_(*i, k)){
+						return i;
+					}
+				}
+				return last;
+			}
+
+			template <class Self, class K>
+			static auto find_impl(Self& self, const K& k) ->
+			  std::conditional_t<std::is_const_v<Self>, const_iterator, iterator> {
+				using result = std::conditional_t<std::is_const_v<Self>, const_iterator, iterator>;
+				auto* b = self.buckets_ + self.bucket(k);
+				auto pos = self.find_in(*b, k);
+				if(pos == b->end()){
+					return result();
+				}
+				return result(b, self.buckets_ + self.bucket_count_, pos);
+			}
+
+			bucket_type* buckets_;
+			size_type bucket_count_;
+			unsigned shift_;
+			size_type size_;
+			[[no_unique_address]] hasher hash_;
+			[[no_unique_address]] key_equal equal_;
+	};
+
+}
+#endif
@@ -0,0 +1,193 @@
+#ifndef WSDEQUEHPP
+#define WSDEQUEHPP
+
+#include"intrusive_list.hpp"
+#include<atomic>
+#include<cstddef>
+#include<cstdint>
+
+namespace ra::intrusive {
+
+	// Intrusive work-stealing deque (Chase and Lev's algorithm, with the
+	// memory orderings of Le, Pop, Cohen and Zappa Nardelli, "Correct and
+	// efficient work-stealing for weak memory models", PPoPP 2013).
+	// One thread, the owner, pushes and pops elements at the bottom of the
+	// deque; any other thread (a thief) may steal elements from the top.
+	// The owner's push and pop perform no atomic read-modify-write
+	// operations, except when pop and a steal compete for the last element.
+	// The deque holds up to Capacity elements in a fixed ring buffer
+	// inside the object, so it never allocates. When the ring buffer is
+	// full, push keeps further elements on an owner-private overflow list
+	// threaded through the list_hook data member Hook of T; these are
+	// returned to the ring buffer (where thieves can see them) as the
+	// owner pops.
+	// Capacity must be a power of two.
+	template <class T, list_hook T::* Hook, std::size_t Capacity = 1024>
+	class ws_deque {
+		static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+		  "the capacity of a ws_deque must be a power of two");
+		public:
+			// The type of the elements in the deque.
+			using value_type = T;
+
+			// An unsigned integral type used to represent sizes.
+			using size_type = std::size_t;
+
+			// The type of the list used for overflow elements and for
+			// batches of stolen elements.
+			using list_type = list<T, Hook>;
+
+			// Creates an empty deque.
+			ws_deque() noexcept : top_(0), bottom_(0) {
+				for(std::atomic<value_type*>& slot : buffer_){
+					slot.store(nullptr, std::memory_order_relaxed);
+				}
+			}
+
+			// Deques cannot be copied or moved.
+			ws_deque(const ws_deque&) = delete;
+			ws_deque& operator=(const ws_deque&) = delete;
+
+			// Destroys the deque. Any elements still in the deque are
+			// simply forgotten.
+			~ws_deque() = default;
+
+			// Pushes the element x onto the bottom of the deque.
+			// Must be called only by the owner.
+			// Time complexity: Constant.
+			void push(value_type& x) noexcept {
+				std::int64_t b = bottom_.load(std::memory_order_relaxed);
+				std::int64_t t = top_.load(std::memory_order_acquire);
+				if(b - t >= std::int64_t(Capacity) || overflow_.size() != 0){
+					// Keep LIFO order for the owner: once elements have
+					// overflowed, newer elements must overflow too.
+					overflow_.push_back(x);
+					return;
+				}
+				buffer_[b & mask].store(&x, std::memory_order_release);
+				std::atomic_thread_fence(std::memory_order_release);
+				bottom_.store(b + 1, std::memory_order_relaxed);
+			}
+
+			// Pops the element at the bottom of the deque (i.e., the most
+			// recently pushed element that has not been stolen), or returns
+			// nullptr if the deque is empty.
+			// Must be called only by the owner.
+			// Time complexity: Constant (amortized, if elements overflowed).
+			value_type* pop() noexcept {
+				if(overflow_.size() != 0){
+					value_type* x = &overflow_.back();
+					overflow_.pop_back();
+					refill();
+					return x;
+				}
+				std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+				bottom_.store(b, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::int64_t t = top_.load(std::memory_order_relaxed);
+				if(t > b){
+					// The deque is empty.
+					bottom_.store(b + 1, std::memory_order_relaxed);
+					return nullptr;
+				}
+				value_type* x = buffer_[b & mask].load(std::memory_order_relaxed);
+				if(t == b){
+					// The last element: compete with thieves for it.
+					if(!top_.compare_exchange_strong(t, t + 1,
+					  std::memory_order_seq_cst, std::memory_order_relaxed)){
+						x = nullptr;
+					}
+					bottom_.store(b + 1, std::memory_order_relaxed);
+				}
+				return x;
+			}
+
+			// Steals the element at the top of the deque (i.e., the least
+			// recently pushed element), or returns nullptr if the deque is
+			// empty or another thread took the element first.
+			// May be called by any thread other than the owner.
+			// Time complexity: Constant.
+			value_type* steal() noexcept {
+				std::int64_t t = top_.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::int64_t b = bottom_.load(std::memory_order_acquire);
+				if(t >= b){
+					return nullptr;
+				}
+				// (The release store and acquire load of the slot are free on
+				// x86 and make the handoff of the element visible to race
+				// detectors, which do not model fences.)
+				value_type* x = buffer_[t & mask].load(std::memory_order_acquire);
+				if(!top_.compare_exchange_strong(t, t + 1,
+				  std::memory_order_seq_cst, std::memory_order_relaxed)){
+					return nullptr;
+				}
+				return x;
+			}
+
+			// Steals up to half of the elements in the deque (at least one,
+			// if the deque is not empty), appending them to the list out in
+			// the order they were pushed. Returns the number of elements
+			// stolen.
+			// Each element is claimed with its own steal, so a batch may be
+			// cut short by contention with the owner or other thieves.
+			// May be called by any thread other than the owner.
+			// Time complexity: Linear in the number of elements stolen.
+			template <class Stats, bool ConstantTimeSize>
+			size_type steal_half(list<T, Hook, Stats, ConstantTimeSize>& out) noexcept {
+				std::int64_t n = bottom_.load(std::memory_order_acquire) -
+				  top_.load(std::memory_order_acquire);
+				size_type k = 0;
+				for(std::int64_t want = n > 1 ? n / 2 : 1; std::int64_t(k) < want; ++k){
+					value_type* x = steal();
+					if(!x){
+						break;
+					}
+					out.push_back(*x);
+				}
+				return k;
+			}
+
+			// Returns the number of elements in the deque. The result is
+			// exact only if no other thread is accessing the deque.
+			// Time complexity: Constant.
+			size_type size() const noexcept {
+				std::int64_t n = bottom_.load(std::memory_order_relaxed) -
+				  top_.load(std::memory_order_relaxed);
+				return (n > 0 ? size_type(n) : 0) + overflow_.size();
+			}
+
+			// Returns true if the deque appears empty (see size()).
+			bool empty() const noexcept { return size() == 0; }
+
+		private:
+			static constexpr std::int64_t mask = std::int64_t(Capacity) - 1;
+
+			// Moves overflow elements into the ring buffer once it is at
+			// most half full, oldest first, so that thieves can see them.
+			void refill() noexcept {
+				std::int64_t b = bottom_.load(std::memory_order_relaxed);
+				std::int64_t t = top_.load(std::memory_order_acquire);
+				if(b - t > std::int64_t(Capacity / 2)){
+					return;
+				}
+				while(overflow_.size() != 0 && b - t < std::int64_t(Capacity)){
+					value_type* x = &overflow_.front();
+					overflow_.pop_front();
+					buffer_[b & mask].store(x, std::memory_order_release);
+					++b;
+				}
+				std::atomic_thread_fence(std::memory_order_release);
+				bottom_.store(b, std::memory_order_relaxed);
+			}
+
+			// The thieves' end and the owner's end are kept on separate
+			// cache lines.
+			alignas(64) std::atomic<std::int64_t> top_;
+			alignas(64) std::atomic<std::int64_t> bottom_;
+			list_type overflow_;
+			std::atomic<value_type*> buffer_[Capacity];
+	};
+
+}
+#endif